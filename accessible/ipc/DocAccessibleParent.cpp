@@ -9,6 +9,7 @@
 #include "xpcAccEvents.h"
 #include "nsAccUtils.h"
 #include "nsCoreUtils.h"
+#include "mozilla/Preferences.h"
 
 #if defined(XP_WIN)
 #  include "AccessibleWrap.h"
@@ -23,8 +24,36 @@ namespace mozilla {
 namespace a11y {
 uint64_t DocAccessibleParent::sMaxDocID = 0;
 
+// The accessibility.ipc.cache pref only affects the non-Windows proxies in
+// accessible/ipc/other. On Windows, ProxyAccessible talks to content through
+// COM proxies and doesn't use this cache.
+static bool CacheEnabled() {
+  static bool sEnabled = true;
+  static bool sCachedPref = false;
+  if (!sCachedPref) {
+    sCachedPref = true;
+    Preferences::AddBoolVarCache(&sEnabled, "accessibility.ipc.cache", true);
+  }
+  return sEnabled;
+}
+
+DocAccessibleParent::CachedAccessibleData* DocAccessibleParent::GetCachedData(
+    uint64_t aID) {
+  if (mShutdown || !CacheEnabled()) {
+    return nullptr;
+  }
+  return mCache.LookupOrAdd(aID);
+}
+
+void DocAccessibleParent::InvalidateAllCaches() {
+  for (auto iter = LiveDocs().Iter(); !iter.Done(); iter.Next()) {
+    iter.Data()->InvalidateCache();
+  }
+}
+
 mozilla::ipc::IPCResult DocAccessibleParent::RecvShowEvent(
     const ShowEventData& aData, const bool& aFromUser) {
+  InvalidateAllCaches();
   if (mShutdown) return IPC_OK();
 
   MOZ_ASSERT(CheckDocTree());
@@ -139,6 +168,7 @@ uint32_t DocAccessibleParent::AddSubtree(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvHideEvent(
     const uint64_t& aRootID, const bool& aFromUser) {
+  InvalidateAllCaches();
   if (mShutdown) return IPC_OK();
 
   MOZ_ASSERT(CheckDocTree());
@@ -193,6 +223,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvHideEvent(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvEvent(
     const uint64_t& aID, const uint32_t& aEventType) {
+  InvalidateCache();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -222,6 +253,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvEvent(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvStateChangeEvent(
     const uint64_t& aID, const uint64_t& aState, const bool& aEnabled) {
+  InvalidateAllCaches();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -258,6 +290,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvCaretMoveEvent(
     const LayoutDeviceIntRect& aCaretRect,
 #endif  // defined (XP_WIN)
     const int32_t& aOffset) {
+  InvalidateCache();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -293,6 +326,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvCaretMoveEvent(
 mozilla::ipc::IPCResult DocAccessibleParent::RecvTextChangeEvent(
     const uint64_t& aID, const nsString& aStr, const int32_t& aStart,
     const uint32_t& aLen, const bool& aIsInsert, const bool& aFromUser) {
+  InvalidateCache();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -333,6 +367,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvSyncTextChangeEvent(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvSelectionEvent(
     const uint64_t& aID, const uint64_t& aWidgetID, const uint32_t& aType) {
+  InvalidateCache();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -363,6 +398,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvVirtualCursorChangeEvent(
     const uint64_t& aNewPositionID, const int32_t& aNewStartOffset,
     const int32_t& aNewEndOffset, const int16_t& aReason,
     const int16_t& aBoundaryType, const bool& aFromUser) {
+  InvalidateCache();
   ProxyAccessible* target = GetAccessible(aID);
   ProxyAccessible* oldPosition = GetAccessible(aOldPositionID);
   ProxyAccessible* newPosition = GetAccessible(aNewPositionID);
@@ -399,6 +435,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvScrollingEvent(
     const uint64_t& aID, const uint64_t& aType, const uint32_t& aScrollX,
     const uint32_t& aScrollY, const uint32_t& aMaxScrollX,
     const uint32_t& aMaxScrollY) {
+  InvalidateCache();
   ProxyAccessible* target = GetAccessible(aID);
 
   if (!target) {
@@ -433,6 +470,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvScrollingEvent(
 mozilla::ipc::IPCResult DocAccessibleParent::RecvAnnouncementEvent(
     const uint64_t& aID, const nsString& aAnnouncement,
     const uint16_t& aPriority) {
+  InvalidateCache();
   ProxyAccessible* target = GetAccessible(aID);
 
   if (!target) {
@@ -461,6 +499,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvAnnouncementEvent(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvRoleChangedEvent(
     const a11y::role& aRole) {
+  InvalidateCache();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -471,6 +510,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvRoleChangedEvent(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvBindChildDoc(
     PDocAccessibleParent* aChildDoc, const uint64_t& aID) {
+  InvalidateCache();
   // One document should never directly be the child of another.
   // We should always have at least an outer doc accessible in between.
   MOZ_ASSERT(aID);
@@ -557,6 +597,7 @@ void DocAccessibleParent::Destroy() {
   }
 
   mShutdown = true;
+  InvalidateCache();
 
   MOZ_DIAGNOSTIC_ASSERT(LiveDocs().Contains(mActorID));
   uint32_t childDocCount = mChildDocs.Length();
@@ -765,6 +806,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvGetWindowedPluginIAccessible(
 
 mozilla::ipc::IPCResult DocAccessibleParent::RecvFocusEvent(
     const uint64_t& aID, const LayoutDeviceIntRect& aCaretRect) {
+  InvalidateAllCaches();
   if (mShutdown) {
     return IPC_OK();
   }
@@ -797,6 +839,7 @@ mozilla::ipc::IPCResult DocAccessibleParent::RecvFocusEvent(
 #if !defined(XP_WIN)
 mozilla::ipc::IPCResult DocAccessibleParent::RecvBatch(
     const uint64_t& aBatchType, nsTArray<BatchData>&& aData) {
+  InvalidateCache();
   // Only do something in Android. We can't ifdef the entire protocol out in
   // the ipdl because it doesn't allow preprocessing.
 #  if defined(ANDROID)
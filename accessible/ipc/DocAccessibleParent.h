@@ -6,6 +6,7 @@
 #define mozilla_a11y_DocAccessibleParent_h
 
 #include "nsAccessibilityService.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/a11y/PDocAccessibleParent.h"
 #include "mozilla/a11y/ProxyAccessible.h"
 #include "nsClassHashtable.h"
@@ -51,6 +52,35 @@ class DocAccessibleParent : public ProxyAccessible,
 
   bool IsShutdown() const { return mShutdown; }
 
+  /*
+   * Results of sync queries about accessibles in this document, so that
+   * screen readers walking a large document don't pay a round trip to the
+   * content process for every state or name. Every event from the content
+   * process, and every request that may change content, drops the whole
+   * cache since we can't tell what changed.
+   */
+  struct CachedAccessibleData {
+    Maybe<uint64_t> mState;
+    Maybe<nsString> mName;
+    Maybe<nsString> mValue;
+    Maybe<nsString> mDescription;
+  };
+
+  /**
+   * Return the cache entry for the accessible with the given ID, or null if
+   * caching is disabled.
+   */
+  CachedAccessibleData* GetCachedData(uint64_t aID);
+
+  void InvalidateCache() { mCache.Clear(); }
+
+  /**
+   * Drop the caches of all live documents. Focus moves, state changes and
+   * tree mutations in one document can change the FOCUSED or OFFSCREEN
+   * state of accessibles in another, e.g. when switching tabs.
+   */
+  static void InvalidateAllCaches();
+
   /**
    * Mark this actor as shutdown without doing any cleanup.  This should only
    * be called on actors that have just been initialized, so probably only from
@@ -275,6 +305,7 @@ class DocAccessibleParent : public ProxyAccessible,
    * proxy object so we can't use a real map.
    */
   nsTHashtable<ProxyEntry> mAccessibles;
+  nsClassHashtable<nsUint64HashKey, CachedAccessibleData> mCache;
   uint64_t mActorID;
   bool mTopLevel;
   bool mShutdown;
@@ -18,8 +18,17 @@ namespace mozilla {
 namespace a11y {
 
 uint64_t ProxyAccessible::State() const {
+  DocAccessibleParent::CachedAccessibleData* cached =
+      mDoc->GetCachedData(mID);
+  if (cached && cached->mState) {
+    return *cached->mState;
+  }
+
   uint64_t state = 0;
   Unused << mDoc->SendState(mID, &state);
+  if (cached) {
+    cached->mState = Some(state);
+  }
   return state;
 }
 
@@ -30,11 +39,31 @@ uint64_t ProxyAccessible::NativeState() const {
 }
 
 void ProxyAccessible::Name(nsString& aName) const {
+  DocAccessibleParent::CachedAccessibleData* cached =
+      mDoc->GetCachedData(mID);
+  if (cached && cached->mName) {
+    aName = *cached->mName;
+    return;
+  }
+
   Unused << mDoc->SendName(mID, &aName);
+  if (cached) {
+    cached->mName = Some(aName);
+  }
 }
 
 void ProxyAccessible::Value(nsString& aValue) const {
+  DocAccessibleParent::CachedAccessibleData* cached =
+      mDoc->GetCachedData(mID);
+  if (cached && cached->mValue) {
+    aValue = *cached->mValue;
+    return;
+  }
+
   Unused << mDoc->SendValue(mID, &aValue);
+  if (cached) {
+    cached->mValue = Some(aValue);
+  }
 }
 
 void ProxyAccessible::Help(nsString& aHelp) const {
@@ -42,7 +71,17 @@ void ProxyAccessible::Help(nsString& aHelp) const {
 }
 
 void ProxyAccessible::Description(nsString& aDesc) const {
+  DocAccessibleParent::CachedAccessibleData* cached =
+      mDoc->GetCachedData(mID);
+  if (cached && cached->mDescription) {
+    aDesc = *cached->mDescription;
+    return;
+  }
+
   Unused << mDoc->SendDescription(mID, &aDesc);
+  if (cached) {
+    cached->mDescription = Some(aDesc);
+  }
 }
 
 void ProxyAccessible::Attributes(nsTArray<Attribute>* aAttrs) const {
@@ -142,6 +181,7 @@ int32_t ProxyAccessible::CaretOffset() {
 }
 
 void ProxyAccessible::SetCaretOffset(int32_t aOffset) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendSetCaretOffset(mID, aOffset);
 }
 
@@ -241,6 +281,7 @@ bool ProxyAccessible::SelectionBoundsAt(int32_t aSelectionNum, nsString& aData,
 bool ProxyAccessible::SetSelectionBoundsAt(int32_t aSelectionNum,
                                            int32_t aStartOffset,
                                            int32_t aEndOffset) {
+  mDoc->InvalidateCache();
   bool retVal = false;
   Unused << mDoc->SendSetSelectionBoundsAt(mID, aSelectionNum, aStartOffset,
                                            aEndOffset, &retVal);
@@ -248,12 +289,14 @@ bool ProxyAccessible::SetSelectionBoundsAt(int32_t aSelectionNum,
 }
 
 bool ProxyAccessible::AddToSelection(int32_t aStartOffset, int32_t aEndOffset) {
+  mDoc->InvalidateCache();
   bool retVal = false;
   Unused << mDoc->SendAddToSelection(mID, aStartOffset, aEndOffset, &retVal);
   return retVal;
 }
 
 bool ProxyAccessible::RemoveFromSelection(int32_t aSelectionNum) {
+  mDoc->InvalidateCache();
   bool retVal = false;
   Unused << mDoc->SendRemoveFromSelection(mID, aSelectionNum, &retVal);
   return retVal;
@@ -279,10 +322,12 @@ void ProxyAccessible::Text(nsString* aText) {
 }
 
 void ProxyAccessible::ReplaceText(const nsString& aText) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendReplaceText(mID, aText);
 }
 
 bool ProxyAccessible::InsertText(const nsString& aText, int32_t aPosition) {
+  mDoc->InvalidateCache();
   bool valid;
   Unused << mDoc->SendInsertText(mID, aText, aPosition, &valid);
   return valid;
@@ -295,18 +340,21 @@ bool ProxyAccessible::CopyText(int32_t aStartPos, int32_t aEndPos) {
 }
 
 bool ProxyAccessible::CutText(int32_t aStartPos, int32_t aEndPos) {
+  mDoc->InvalidateCache();
   bool valid;
   Unused << mDoc->SendCutText(mID, aStartPos, aEndPos, &valid);
   return valid;
 }
 
 bool ProxyAccessible::DeleteText(int32_t aStartPos, int32_t aEndPos) {
+  mDoc->InvalidateCache();
   bool valid;
   Unused << mDoc->SendDeleteText(mID, aStartPos, aEndPos, &valid);
   return valid;
 }
 
 bool ProxyAccessible::PasteText(int32_t aPosition) {
+  mDoc->InvalidateCache();
   bool valid;
   Unused << mDoc->SendPasteText(mID, aPosition, &valid);
   return valid;
@@ -590,18 +638,22 @@ void ProxyAccessible::TableSelectedRowIndices(nsTArray<uint32_t>* aRowIndices) {
 }
 
 void ProxyAccessible::TableSelectColumn(uint32_t aCol) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendTableSelectColumn(mID, aCol);
 }
 
 void ProxyAccessible::TableSelectRow(uint32_t aRow) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendTableSelectRow(mID, aRow);
 }
 
 void ProxyAccessible::TableUnselectColumn(uint32_t aCol) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendTableUnselectColumn(mID, aCol);
 }
 
 void ProxyAccessible::TableUnselectRow(uint32_t aRow) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendTableUnselectRow(mID, aRow);
 }
 
@@ -655,38 +707,45 @@ bool ProxyAccessible::IsItemSelected(uint32_t aIndex) {
 }
 
 bool ProxyAccessible::AddItemToSelection(uint32_t aIndex) {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendAddItemToSelection(mID, aIndex, &success);
   return success;
 }
 
 bool ProxyAccessible::RemoveItemFromSelection(uint32_t aIndex) {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendRemoveItemFromSelection(mID, aIndex, &success);
   return success;
 }
 
 bool ProxyAccessible::SelectAll() {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendSelectAll(mID, &success);
   return success;
 }
 
 bool ProxyAccessible::UnselectAll() {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendUnselectAll(mID, &success);
   return success;
 }
 
 void ProxyAccessible::TakeSelection() {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendTakeSelection(mID);
 }
 
 void ProxyAccessible::SetSelected(bool aSelect) {
+  mDoc->InvalidateCache();
   Unused << mDoc->SendSetSelected(mID, aSelect);
 }
 
 bool ProxyAccessible::DoAction(uint8_t aIndex) {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendDoAction(mID, aIndex, &success);
   return success;
@@ -732,6 +791,7 @@ double ProxyAccessible::CurValue() {
 }
 
 bool ProxyAccessible::SetCurValue(double aValue) {
+  mDoc->InvalidateCache();
   bool success = false;
   Unused << mDoc->SendSetCurValue(mID, aValue, &success);
   return success;
@@ -755,7 +815,10 @@ double ProxyAccessible::Step() {
   return step;
 }
 
-void ProxyAccessible::TakeFocus() { Unused << mDoc->SendTakeFocus(mID); }
+void ProxyAccessible::TakeFocus() {
+  mDoc->InvalidateCache();
+  Unused << mDoc->SendTakeFocus(mID);
+}
 
 ProxyAccessible* ProxyAccessible::FocusedChild() {
   uint64_t childID = 0;
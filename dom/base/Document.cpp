@@ -1142,6 +1142,53 @@ void Document::SelectorCache::NotifyExpired(SelectorCacheKey* aSelector) {
   delete aSelector;
 }
 
+// Don't bother caching huge result lists, copying them out isn't much
+// cheaper than matching again.
+#define MAX_QUERY_SELECTOR_ALL_CACHE_RESULTS 4096
+#define MAX_QUERY_SELECTOR_ALL_CACHE_ENTRIES 64
+
+const nsTArray<Element*>* Document::QuerySelectorAllCache::Get(
+    const nsINode* aRoot, const nsAString& aSelector,
+    uint64_t aDOMGeneration) {
+  if (aDOMGeneration != mDOMGeneration) {
+    mTable.Clear();
+    mDOMGeneration = aDOMGeneration;
+    return nullptr;
+  }
+
+  Entry* entry = mTable.Get(aSelector);
+  if (!entry || entry->mRoot != aRoot) {
+    return nullptr;
+  }
+  return &entry->mElements;
+}
+
+void Document::QuerySelectorAllCache::Put(const nsINode* aRoot,
+                                          const nsAString& aSelector,
+                                          uint64_t aDOMGeneration,
+                                          nsBaseContentList& aResults) {
+  if (aDOMGeneration != mDOMGeneration) {
+    mTable.Clear();
+    mDOMGeneration = aDOMGeneration;
+  }
+
+  uint32_t length = aResults.Length();
+  if (length > MAX_QUERY_SELECTOR_ALL_CACHE_RESULTS) {
+    return;
+  }
+  if (mTable.Count() >= MAX_QUERY_SELECTOR_ALL_CACHE_ENTRIES) {
+    mTable.Clear();
+  }
+
+  Entry* entry = mTable.LookupOrAdd(aSelector);
+  entry->mRoot = aRoot;
+  entry->mElements.Clear();
+  entry->mElements.SetCapacity(length);
+  for (uint32_t i = 0; i < length; ++i) {
+    entry->mElements.AppendElement(aResults.Item(i)->AsElement());
+  }
+}
+
 Document::FrameRequest::FrameRequest(FrameRequestCallback& aCallback,
                                      int32_t aHandle)
     : mCallback(&aCallback), mHandle(aHandle) {}
@@ -1306,6 +1353,7 @@ Document::Document(const char* aContentType)
       mSavedResolution(1.0f),
       mPendingInitialTranslation(false),
       mGeneration(0),
+      mDOMGeneration(0),
       mCachedTabSizeGeneration(0),
       mInRDMPane(false) {
   MOZ_LOG(gDocumentLeakPRLog, LogLevel::Debug, ("DOCUMENT %p created", this));
@@ -2496,6 +2544,8 @@ void Document::FillStyleSetDocumentSheets() {
 
 void Document::CompatibilityModeChanged() {
   MOZ_ASSERT(IsHTMLOrXHTML());
+  // Class and id selectors may have changed case-sensitivity.
+  DOMMutated();
   CSSLoader()->SetCompatibilityMode(mCompatMode);
   mStyleSet->CompatibilityModeChanged();
   if (PresShell* presShell = GetPresShell()) {
@@ -117,6 +117,7 @@ class nsIVariant;
 class nsViewManager;
 class nsPresContext;
 class nsRange;
+class nsBaseContentList;
 class nsSimpleContentList;
 class nsTextNode;
 class nsWindowSizes;
@@ -1506,6 +1507,14 @@ class Document : public nsINode,
   // Returns the current generation.
   inline int32_t GetGeneration() const { return mGeneration; }
 
+  // Increments the DOM generation.  Unlike Changed(), this is called for
+  // every child list and attribute mutation of nodes owned by this document,
+  // including those made without notifying.
+  inline void DOMMutated() { ++mDOMGeneration; }
+
+  // Returns the current DOM generation.
+  inline uint64_t GetDOMGeneration() const { return mDOMGeneration; }
+
   // Adds cached sizes values to aSizes if there's any
   // cached value and if the document generation hasn't
   // changed since the cache was created.
@@ -1631,6 +1640,41 @@ class Document : public nsINode,
     }
     return *mSelectorCache;
   }
+
+  // Caches querySelectorAll results for selectors which only depend on the
+  // tree and on attributes, keyed by selector and root.  Results are only
+  // valid for the DOM generation they were computed at, see
+  // nsINode::QuerySelectorAll.
+  class QuerySelectorAllCache final {
+   public:
+    QuerySelectorAllCache() : mDOMGeneration(0) {}
+
+    // Returns the cached matches for aSelector under aRoot, or null.
+    const nsTArray<Element*>* Get(const nsINode* aRoot,
+                                  const nsAString& aSelector,
+                                  uint64_t aDOMGeneration);
+
+    void Put(const nsINode* aRoot, const nsAString& aSelector,
+             uint64_t aDOMGeneration, nsBaseContentList& aResults);
+
+   private:
+    struct Entry {
+      // Not owning: the root and results are in the document, so dropping
+      // them bumps the DOM generation and invalidates the entry.
+      const nsINode* mRoot;
+      nsTArray<Element*> mElements;
+    };
+
+    nsClassHashtable<nsStringHashKey, Entry> mTable;
+    uint64_t mDOMGeneration;
+  };
+
+  QuerySelectorAllCache& GetQuerySelectorAllCache() {
+    if (!mQuerySelectorAllCache) {
+      mQuerySelectorAllCache = MakeUnique<QuerySelectorAllCache>();
+    }
+    return *mQuerySelectorAllCache;
+  }
   // Get the root <html> element, or return null if there isn't one (e.g.
   // if the root isn't <html>)
   Element* GetHtmlElement() const;
@@ -3907,6 +3951,7 @@ class Document : public nsINode,
   // Lazy-initialization to have mDocGroup initialized in prior to the
   // SelectorCaches.
   UniquePtr<SelectorCache> mSelectorCache;
+  UniquePtr<QuerySelectorAllCache> mQuerySelectorAllCache;
   UniquePtr<ServoStyleSet> mStyleSet;
 
  protected:
@@ -4784,6 +4829,9 @@ class Document : public nsINode,
   // Document generation. Gets incremented everytime it changes.
   int32_t mGeneration;
 
+  // DOM generation, see DOMMutated().
+  uint64_t mDOMGeneration;
+
   // Cached TabSizes values for the document.
   int32_t mCachedTabSizeGeneration;
   nsTabSizes mCachedTabSizes;
@@ -2452,6 +2452,7 @@ nsresult Element::SetAttrAndNotify(
     const mozAutoDocUpdate&) {
   nsresult rv;
   nsMutationGuard::DidMutate();
+  OwnerDoc()->DOMMutated();
 
   // Copy aParsedValue for later use since it will be lost when we call
   // SetAndSwapMappedAttr below
@@ -2762,6 +2763,7 @@ nsresult Element::UnsetAttr(int32_t aNameSpaceID, nsAtom* aName, bool aNotify) {
   // The id-handling code, and in the future possibly other code, need to
   // react to unexpected attribute changes.
   nsMutationGuard::DidMutate();
+  OwnerDoc()->DOMMutated();
 
   bool hadValidDir = false;
   bool hadDirAuto = false;
@@ -49,6 +49,7 @@
 #include "nsIServiceManager.h"
 #include "nsDOMCSSAttrDeclaration.h"
 #include "nsNameSpaceManager.h"
+#include "nsChildIndexCache.h"
 #include "nsContentList.h"
 #include "nsDOMTokenList.h"
 #include "nsXBLPrototypeBinding.h"
@@ -547,6 +548,7 @@ void nsIContent::nsExtendedContentSlots::UnlinkExtendedSlots() {
   mXBLInsertionPoint = nullptr;
   mContainingShadow = nullptr;
   mAssignedSlot = nullptr;
+  mChildIndexCache = nullptr;
 }
 
 void nsIContent::nsExtendedContentSlots::TraverseExtendedSlots(
@@ -570,9 +572,9 @@ nsIContent::nsExtendedContentSlots::~nsExtendedContentSlots() = default;
 
 size_t nsIContent::nsExtendedContentSlots::SizeOfExcludingThis(
     MallocSizeOf aMallocSizeOf) const {
-  // For now, nothing to measure here.  We don't actually own any of our
-  // members.
-  return 0;
+  // We don't own any of our other members.
+  return mChildIndexCache ? mChildIndexCache->SizeOfIncludingThis(aMallocSizeOf)
+                          : 0;
 }
 
 FragmentOrElement::nsDOMSlots::nsDOMSlots()
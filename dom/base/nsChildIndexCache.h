@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsChildIndexCache_h___
+#define nsChildIndexCache_h___
+
+#include "mozilla/MemoryReporting.h"
+#include "nsDataHashtable.h"
+#include "nsHashKeys.h"
+#include "nsIContent.h"
+#include "nsTArray.h"
+
+// The table is only rebuilt after this many lookups miss it, so that code
+// interleaving mutations and lookups doesn't pay for a full rebuild each time.
+#define CHILD_INDEX_CACHE_REBUILD_MISSES 4
+
+/**
+ * A table mapping indices to children and back for a node with a large child
+ * list, see nsINode::GetChildIndexCache. It holds no references: the owner
+ * invalidates it on every child list mutation.
+ */
+class nsChildIndexCache final {
+ public:
+  nsChildIndexCache() : mMisses(0), mIsValid(false) {}
+
+  void Invalidate() {
+    if (mIsValid) {
+      mChildren.Clear();
+      mIndices.Clear();
+      mIsValid = false;
+    }
+    mMisses = 0;
+  }
+
+  // Returns true if the table can be used for a lookup on aParent, building
+  // it if enough lookups have missed since the last mutation.
+  bool EnsureValid(const nsINode* aParent) {
+    if (mIsValid) {
+      return true;
+    }
+    if (++mMisses < CHILD_INDEX_CACHE_REBUILD_MISSES) {
+      return false;
+    }
+
+    mChildren.SetCapacity(aParent->GetChildCount());
+    uint32_t index = 0;
+    for (nsIContent* child = aParent->GetFirstChild(); child;
+         child = child->GetNextSibling()) {
+      mChildren.AppendElement(child);
+      mIndices.Put(child, index++);
+    }
+    mIsValid = true;
+    return true;
+  }
+
+  int32_t IndexOf(const nsINode* aChild) const {
+    MOZ_ASSERT(mIsValid);
+    uint32_t index;
+    return mIndices.Get(aChild, &index) ? int32_t(index) : -1;
+  }
+
+  nsIContent* ChildAt(uint32_t aIndex) const {
+    MOZ_ASSERT(mIsValid);
+    return mChildren.SafeElementAt(aIndex);
+  }
+
+  size_t SizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const {
+    return aMallocSizeOf(this) +
+           mChildren.ShallowSizeOfExcludingThis(aMallocSizeOf) +
+           mIndices.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  }
+
+ private:
+  nsTArray<nsIContent*> mChildren;
+  nsDataHashtable<nsPtrHashKey<const nsINode>, uint32_t> mIndices;
+  uint32_t mMisses;
+  bool mIsValid;
+};
+
+#endif /* nsChildIndexCache_h___ */
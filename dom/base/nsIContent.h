@@ -6,6 +6,7 @@
 
 #include "mozilla/Attributes.h"
 #include "mozilla/FlushType.h"
+#include "mozilla/UniquePtr.h"
 #include "mozilla/dom/BorrowedAttrInfo.h"
 #include "nsCaseTreatment.h"  // for enum, cannot be forward-declared
 #include "nsINode.h"
@@ -761,6 +762,11 @@ class nsIContent : public nsINode {
      * @see nsIContent::GetAssignedSlot
      */
     RefPtr<mozilla::dom::HTMLSlotElement> mAssignedSlot;
+
+    /**
+     * @see nsINode::GetChildIndexCache
+     */
+    mozilla::UniquePtr<nsChildIndexCache> mChildIndexCache;
   };
 
   class nsContentSlots : public nsINode::nsSlots {
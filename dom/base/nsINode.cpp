@@ -38,6 +38,7 @@
 #include "nsAttrValueOrString.h"
 #include "nsBindingManager.h"
 #include "nsCCUncollectableMarker.h"
+#include "nsChildIndexCache.h"
 #include "nsContentCreatorFunctions.h"
 #include "nsContentList.h"
 #include "nsContentUtils.h"
@@ -1338,11 +1339,55 @@ static inline void RemoveFromCache(const nsINode* aParent) {
   }
 }
 
+// Nodes with at least CHILD_INDEX_CACHE_LIMIT children (log views, big
+// tables) get a table mapping indices to children and back, so that range
+// and selection code calling ComputeIndexOf in a loop isn't quadratic.
+// The table is emptied on every child list mutation, and only rebuilt after
+// CHILD_INDEX_CACHE_REBUILD_MISSES lookups, see nsChildIndexCache.
+#define CHILD_INDEX_CACHE_LIMIT 1000
+
+nsChildIndexCache* nsINode::GetChildIndexCache() const {
+  // Documents never have that many children. Content nodes keep the table in
+  // their extended slots, with the other rarely used data.
+  if (mChildCount < CHILD_INDEX_CACHE_LIMIT || !IsContent()) {
+    return nullptr;
+  }
+
+  nsIContent* self = const_cast<nsINode*>(this)->AsContent();
+  if (GetBoolFlag(NodeHasChildIndexCache)) {
+    // The table is dropped on unlink, in which case we create a new one.
+    nsIContent::nsExtendedContentSlots* slots =
+        self->GetExistingExtendedContentSlots();
+    if (slots && slots->mChildIndexCache) {
+      return slots->mChildIndexCache.get();
+    }
+  }
+
+  nsIContent::nsExtendedContentSlots* slots = self->ExtendedContentSlots();
+  slots->mChildIndexCache = MakeUnique<nsChildIndexCache>();
+  self->SetBoolFlag(NodeHasChildIndexCache);
+  return slots->mChildIndexCache.get();
+}
+
+void nsINode::InvalidateChildIndexCache() {
+  if (!GetBoolFlag(NodeHasChildIndexCache)) {
+    return;
+  }
+
+  nsIContent::nsExtendedContentSlots* slots =
+      AsContent()->GetExistingExtendedContentSlots();
+  if (slots && slots->mChildIndexCache) {
+    slots->mChildIndexCache->Invalidate();
+  }
+}
+
 void nsINode::AppendChildToChildList(nsIContent* aKid) {
   MOZ_ASSERT(aKid);
   MOZ_ASSERT(!aKid->mNextSibling);
 
   RemoveFromCache(this);
+  InvalidateChildIndexCache();
+  OwnerDoc()->DOMMutated();
 
   if (mFirstChild) {
     nsIContent* lastChild = GetLastChild();
@@ -1363,6 +1408,8 @@ void nsINode::InsertChildToChildList(nsIContent* aKid,
   MOZ_ASSERT(aNextSibling);
 
   RemoveFromCache(this);
+  InvalidateChildIndexCache();
+  OwnerDoc()->DOMMutated();
 
   nsIContent* previousSibling = aNextSibling->mPreviousOrLastSibling;
   aNextSibling->mPreviousOrLastSibling = aKid;
@@ -1384,6 +1431,8 @@ void nsINode::DisconnectChild(nsIContent* aKid) {
   MOZ_ASSERT(GetChildCount() > 0);
 
   RemoveFromCache(this);
+  InvalidateChildIndexCache();
+  OwnerDoc()->DOMMutated();
 
   nsIContent* previousSibling = aKid->GetPreviousSibling();
   nsCOMPtr<nsIContent> ref = aKid;
@@ -1411,6 +1460,12 @@ nsIContent* nsINode::GetChildAt_Deprecated(uint32_t aIndex) const {
     return nullptr;
   }
 
+  if (nsChildIndexCache* indexCache = GetChildIndexCache()) {
+    if (indexCache->EnsureValid(this)) {
+      return indexCache->ChildAt(aIndex);
+    }
+  }
+
   nsIContent* child = mFirstChild;
   while (aIndex--) {
     child = child->GetNextSibling();
@@ -1432,6 +1487,12 @@ int32_t nsINode::ComputeIndexOf(const nsINode* aChild) const {
     return GetChildCount() - 1;
   }
 
+  if (nsChildIndexCache* indexCache = GetChildIndexCache()) {
+    if (indexCache->EnsureValid(this)) {
+      return indexCache->IndexOf(aChild);
+    }
+  }
+
   if (mChildCount >= CACHE_CHILD_LIMIT) {
     const nsINode* child;
     int32_t childIndex;
@@ -2560,6 +2621,24 @@ Element* nsINode::QuerySelector(const nsAString& aSelector,
       Servo_SelectorList_QueryFirst(this, list, useInvalidation));
 }
 
+static bool QuerySelectorAllCacheEnabled() {
+  static bool sEnabled = true;
+  static bool sCachedPref = false;
+  if (!sCachedPref) {
+    sCachedPref = true;
+    Preferences::AddBoolVarCache(&sEnabled, "dom.querySelectorAll.cache",
+                                 true);
+  }
+  return sEnabled;
+}
+
+// Selectors without pseudo-classes or pseudo-elements can't depend on
+// element state, only on the tree and on attributes, so their results stay
+// valid until the DOM generation of the document changes.
+static bool IsCacheableSelector(const nsAString& aSelector) {
+  return aSelector.FindChar(':') == kNotFound;
+}
+
 already_AddRefed<nsINodeList> nsINode::QuerySelectorAll(
     const nsAString& aSelector, ErrorResult& aResult) {
   AUTO_PROFILER_LABEL_DYNAMIC_LOSSY_NSSTRING("nsINode::QuerySelectorAll",
@@ -2571,8 +2650,28 @@ already_AddRefed<nsINodeList> nsINode::QuerySelectorAll(
     return contentList.forget();
   }
 
+  // Shadow trees and disconnected subtrees aren't cached, since nodes there
+  // can go away without a mutation of the owner document.
+  Document* doc = OwnerDoc();
+  Document::QuerySelectorAllCache* resultCache = nullptr;
+  if (IsInUncomposedDoc() && QuerySelectorAllCacheEnabled() &&
+      IsCacheableSelector(aSelector)) {
+    resultCache = &doc->GetQuerySelectorAllCache();
+    if (const nsTArray<Element*>* elements =
+            resultCache->Get(this, aSelector, doc->GetDOMGeneration())) {
+      contentList->SetCapacity(elements->Length());
+      for (Element* element : *elements) {
+        contentList->AppendElement(element);
+      }
+      return contentList.forget();
+    }
+  }
+
   const bool useInvalidation = false;
   Servo_SelectorList_QueryAll(this, list, contentList.get(), useInvalidation);
+  if (resultCache) {
+    resultCache->Put(this, aSelector, doc->GetDOMGeneration(), *contentList);
+  }
   return contentList.forget();
 }
 
@@ -35,6 +35,7 @@
 
 class AttrArray;
 class nsAttrChildContentList;
+class nsChildIndexCache;
 class nsDOMAttributeMap;
 class nsIAnimationObserver;
 class nsIContent;
@@ -1255,6 +1256,14 @@ class nsINode : public mozilla::dom::EventTarget {
   void InsertChildToChildList(nsIContent* aKid, nsIContent* aNextSibling);
   void DisconnectChild(nsIContent* aKid);
 
+  /**
+   * Returns the child index table used by ComputeIndexOf and
+   * GetChildAt_Deprecated for large child lists, creating it if needed.
+   * Returns null if this node doesn't have enough children to need one.
+   */
+  nsChildIndexCache* GetChildIndexCache() const;
+  void InvalidateChildIndexCache();
+
  public:
   void LookupPrefix(const nsAString& aNamespace, nsAString& aResult);
   bool IsDefaultNamespace(const nsAString& aNamespaceURI) {
@@ -1449,6 +1458,9 @@ class nsINode : public mozilla::dom::EventTarget {
     ElementMayHaveAnonymousChildren,
     // Set if element has CustomElementData.
     ElementHasCustomElementData,
+    // Set if the node has created a child index table in its extended slots,
+    // see GetChildIndexCache.
+    NodeHasChildIndexCache,
     // Guard value
     BooleanFlagCount
   };
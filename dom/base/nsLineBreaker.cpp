@@ -9,9 +9,47 @@
 #include "nsHyphenator.h"
 #include "mozilla/gfx/2D.h"
 #include "mozilla/intl/LineBreaker.h"
+#include "mozilla/SSE.h"
 
 using mozilla::intl::LineBreaker;
 
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+namespace mozilla {
+namespace SSE2 {
+uint32_t CountAlphanumerics(const uint8_t* aText, uint32_t aLength);
+uint32_t CountAlphanumerics(const char16_t* aText, uint32_t aLength);
+}  // namespace SSE2
+}  // namespace mozilla
+#endif
+
+template <typename CharT>
+static inline uint32_t CountAlphanumericsUnvectorized(const CharT* aText,
+                                                      uint32_t aLength) {
+  uint32_t i = 0;
+  while (i < aLength && (('0' <= aText[i] && aText[i] <= '9') ||
+                         ('a' <= aText[i] && aText[i] <= 'z') ||
+                         ('A' <= aText[i] && aText[i] <= 'Z'))) {
+    ++i;
+  }
+  return i;
+}
+
+/*
+ * Return the length of the run of ASCII letters and digits at the start of
+ * aText. Inside a word such characters are neither spaces nor complex, so
+ * they never create a break opportunity and can be skipped in bulk.
+ */
+template <typename CharT>
+static inline uint32_t CountAlphanumerics(const CharT* aText,
+                                          uint32_t aLength) {
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+  if (mozilla::supports_sse2()) {
+    return mozilla::SSE2::CountAlphanumerics(aText, aLength);
+  }
+#endif
+  return CountAlphanumericsUnvectorized(aText, aLength);
+}
+
 nsLineBreaker::nsLineBreaker()
     : mCurrentWordLanguage(nullptr),
       mCurrentWordContainsMixedLang(false),
@@ -261,6 +299,19 @@ nsresult nsLineBreaker::AppendText(nsAtom* aHyphenationLanguage,
         wordHasComplexChar = true;
       }
       ++offset;
+      // The rest of an alphanumeric run can't start a break, and the state
+      // flags are already clear after this non-space character.
+      uint32_t run = CountAlphanumerics(aText + offset, aLength - offset);
+      if (run > 0) {
+        if (aSink && !noBreaksNeeded) {
+          memset(breakState.Elements() + offset,
+                 mWordBreak == LineBreaker::kWordBreak_BreakAll
+                     ? gfxTextRun::CompressedGlyph::FLAG_BREAK_TYPE_NORMAL
+                     : gfxTextRun::CompressedGlyph::FLAG_BREAK_TYPE_NONE,
+                 run * sizeof(uint8_t));
+        }
+        offset += run;
+      }
       if (offset >= aLength) {
         // Save this word
         mCurrentWordContainsComplexChar = wordHasComplexChar;
@@ -410,6 +461,19 @@ nsresult nsLineBreaker::AppendText(nsAtom* aHyphenationLanguage,
         wordHasComplexChar = true;
       }
       ++offset;
+      // The rest of an alphanumeric run can't start a break, and the state
+      // flags are already clear after this non-space character.
+      uint32_t run = CountAlphanumerics(aText + offset, aLength - offset);
+      if (run > 0) {
+        if (aSink) {
+          memset(breakState.Elements() + offset,
+                 mWordBreak == LineBreaker::kWordBreak_BreakAll
+                     ? gfxTextRun::CompressedGlyph::FLAG_BREAK_TYPE_NORMAL
+                     : gfxTextRun::CompressedGlyph::FLAG_BREAK_TYPE_NONE,
+                 run * sizeof(uint8_t));
+        }
+        offset += run;
+      }
       if (offset >= aLength) {
         // Save this word
         mCurrentWordContainsComplexChar = wordHasComplexChar;
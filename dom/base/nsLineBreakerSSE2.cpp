@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// This file should only be compiled if you're on x86 or x86_64.  Additionally,
+// you'll need to compile this file with -msse2 if you're using gcc.
+
+#include <emmintrin.h>
+#include "nscore.h"
+#include "mozilla/MathAlgorithms.h"
+
+namespace mozilla {
+namespace SSE2 {
+
+// Returns a mask with a bit set for each byte of aVect that is not an ASCII
+// letter or digit.
+static inline int NonAlphanumericMask(__m128i aVect) {
+  // Unsigned range checks: (x - lo) <= (hi - lo) <=> min(x - lo, hi - lo)
+  // == x - lo. Letters are folded to lowercase first by setting bit 0x20,
+  // which also maps '@', '[' etc. to non-letters outside 'a'..'z'.
+  const __m128i digit = _mm_sub_epi8(aVect, _mm_set1_epi8('0'));
+  const __m128i isDigit =
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  const __m128i letter = _mm_sub_epi8(_mm_or_si128(aVect, _mm_set1_epi8(0x20)),
+                                      _mm_set1_epi8('a'));
+  const __m128i isLetter =
+      _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(25)), letter);
+  return ~_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) & 0xffff;
+}
+
+static inline bool IsAlphanumeric(char16_t aChar) {
+  return ('0' <= aChar && aChar <= '9') || ('a' <= aChar && aChar <= 'z') ||
+         ('A' <= aChar && aChar <= 'Z');
+}
+
+uint32_t CountAlphanumerics(const uint8_t* aText, uint32_t aLength) {
+  uint32_t i = 0;
+  for (; i + 16 <= aLength; i += 16) {
+    const __m128i vect =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + i));
+    int mask = NonAlphanumericMask(vect);
+    if (mask) {
+      return i + CountTrailingZeroes32(mask);
+    }
+  }
+  for (; i < aLength && IsAlphanumeric(aText[i]); ++i) {
+  }
+  return i;
+}
+
+uint32_t CountAlphanumerics(const char16_t* aText, uint32_t aLength) {
+  uint32_t i = 0;
+  for (; i + 16 <= aLength; i += 16) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(aText + i + 8));
+    // _mm_packus_epi16 saturates signed 16-bit inputs: U+0100..U+7FFF become
+    // 0xFF and U+8000..U+FFFF, being negative, become 0x00. Neither 0xFF nor
+    // NUL is alphanumeric, so the byte test below is still exact.
+    int mask = NonAlphanumericMask(_mm_packus_epi16(lo, hi));
+    if (mask) {
+      return i + CountTrailingZeroes32(mask);
+    }
+  }
+  for (; i < aLength && IsAlphanumeric(aText[i]); ++i) {
+  }
+  return i;
+}
+
+}  // namespace SSE2
+}  // namespace mozilla
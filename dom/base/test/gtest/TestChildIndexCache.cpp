@@ -0,0 +1,127 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/Document.h"
+#include "mozilla/dom/Element.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/NullPrincipal.h"
+#include "nsChildIndexCache.h"
+#include "nsGkAtoms.h"
+#include "nsNetUtil.h"
+
+using mozilla::ErrorResult;
+using mozilla::NullPrincipal;
+using namespace mozilla::dom;
+
+// Enough children for the parent to get a child index table.
+static const uint32_t kLargeChildCount = 1200;
+
+static already_AddRefed<Element> CreateLargeParent(RefPtr<Document>& aDoc) {
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "about:blank");
+  nsCOMPtr<nsIPrincipal> principal =
+      NullPrincipal::CreateWithoutOriginAttributes();
+  RefPtr<Document> doc;
+  nsresult rv = NS_NewDOMDocument(getter_AddRefs(doc),
+                                  EmptyString(),  // aNamespaceURI
+                                  EmptyString(),  // aQualifiedName
+                                  nullptr,        // aDoctype
+                                  uri, uri, principal,
+                                  false,    // aLoadedAsData
+                                  nullptr,  // aEventObject
+                                  DocumentFlavorHTML);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return nullptr;
+  }
+
+  ErrorResult error;
+  RefPtr<Element> parent = doc->CreateHTMLElement(nsGkAtoms::div);
+  for (uint32_t i = 0; i < kLargeChildCount; ++i) {
+    RefPtr<Element> child = doc->CreateHTMLElement(nsGkAtoms::span);
+    parent->AppendChild(*child, error);
+  }
+  if (NS_WARN_IF(error.Failed())) {
+    error.SuppressException();
+    return nullptr;
+  }
+
+  aDoc = doc;
+  return parent.forget();
+}
+
+// Checks ComputeIndexOf and GetChildAt_Deprecated against a walk of the
+// child list, for every child and past the end. Each pass does far more than
+// CHILD_INDEX_CACHE_REBUILD_MISSES lookups, so it covers the lookups that
+// walk the list as well as the ones served by the rebuilt table.
+static void ExpectIndicesMatchWalk(nsINode& aParent) {
+  uint32_t index = 0;
+  for (nsIContent* child = aParent.GetFirstChild(); child;
+       child = child->GetNextSibling(), ++index) {
+    EXPECT_EQ(aParent.ComputeIndexOf(child), int32_t(index));
+    EXPECT_EQ(aParent.GetChildAt_Deprecated(index), child);
+  }
+  EXPECT_EQ(index, aParent.GetChildCount());
+  EXPECT_FALSE(aParent.GetChildAt_Deprecated(index));
+}
+
+TEST(DOM_Base_ChildIndexCache, Mutations)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> parent = CreateLargeParent(doc);
+  ASSERT_TRUE(parent);
+  ExpectIndicesMatchWalk(*parent);
+
+  ErrorResult error;
+
+  RefPtr<Element> appended = doc->CreateHTMLElement(nsGkAtoms::b);
+  parent->AppendChild(*appended, error);
+  ASSERT_FALSE(error.Failed());
+  EXPECT_EQ(parent->ComputeIndexOf(appended), int32_t(kLargeChildCount));
+  ExpectIndicesMatchWalk(*parent);
+
+  RefPtr<Element> inserted = doc->CreateHTMLElement(nsGkAtoms::i);
+  nsCOMPtr<nsINode> before = parent->GetChildAt_Deprecated(500);
+  parent->InsertBefore(*inserted, before, error);
+  ASSERT_FALSE(error.Failed());
+  EXPECT_EQ(parent->ComputeIndexOf(inserted), 500);
+  EXPECT_EQ(parent->ComputeIndexOf(before), 501);
+  ExpectIndicesMatchWalk(*parent);
+
+  nsCOMPtr<nsINode> removed = parent->GetChildAt_Deprecated(10);
+  nsCOMPtr<nsINode> next = parent->GetChildAt_Deprecated(11);
+  parent->RemoveChild(*removed, error);
+  ASSERT_FALSE(error.Failed());
+  EXPECT_EQ(parent->ComputeIndexOf(removed), -1);
+  EXPECT_EQ(parent->ComputeIndexOf(next), 10);
+  ExpectIndicesMatchWalk(*parent);
+
+  // A node that isn't a child is never found, through the table or not.
+  RefPtr<Element> stranger = doc->CreateHTMLElement(nsGkAtoms::span);
+  for (uint32_t i = 0; i < 2 * CHILD_INDEX_CACHE_REBUILD_MISSES; ++i) {
+    EXPECT_EQ(parent->ComputeIndexOf(stranger), -1);
+  }
+}
+
+TEST(DOM_Base_ChildIndexCache, InterleavedMutationsAndLookups)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> parent = CreateLargeParent(doc);
+  ASSERT_TRUE(parent);
+
+  // Every mutation empties the table, so these lookups mostly walk the list,
+  // and the ones after a rebuild must see the latest child list.
+  ErrorResult error;
+  for (uint32_t i = 0; i < 20; ++i) {
+    RefPtr<Element> child = doc->CreateHTMLElement(nsGkAtoms::span);
+    nsCOMPtr<nsINode> before = parent->GetChildAt_Deprecated(i * 7);
+    parent->InsertBefore(*child, before, error);
+    ASSERT_FALSE(error.Failed());
+    for (uint32_t j = 0; j <= i % 6; ++j) {
+      EXPECT_EQ(parent->ComputeIndexOf(child), int32_t(i * 7));
+      EXPECT_EQ(parent->GetChildAt_Deprecated(i * 7), child.get());
+    }
+  }
+  ExpectIndicesMatchWalk(*parent);
+}
@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+
+#include "mozilla/SSE.h"
+#include "nsTArray.h"
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+
+namespace mozilla {
+namespace SSE2 {
+uint32_t CountAlphanumerics(const uint8_t* aText, uint32_t aLength);
+uint32_t CountAlphanumerics(const char16_t* aText, uint32_t aLength);
+}  // namespace SSE2
+}  // namespace mozilla
+
+template <typename CharT>
+static uint32_t CountAlphanumericsScalar(const CharT* aText,
+                                         uint32_t aLength) {
+  uint32_t i = 0;
+  while (i < aLength && (('0' <= aText[i] && aText[i] <= '9') ||
+                         ('a' <= aText[i] && aText[i] <= 'z') ||
+                         ('A' <= aText[i] && aText[i] <= 'Z'))) {
+    ++i;
+  }
+  return i;
+}
+
+// Fills aText with letters and digits, puts aStop at aStopIndex (if it is in
+// range) and checks the SSE2 count against the scalar one for every length.
+template <typename CharT>
+static void CheckStopAt(CharT aStop, uint32_t aStopIndex) {
+  static const char kAlphanumerics[] = "aZ09zA5mQ";
+  const uint32_t kMaxLength = 48;
+
+  nsTArray<CharT> text;
+  for (uint32_t i = 0; i < kMaxLength; ++i) {
+    text.AppendElement(
+        CharT(kAlphanumerics[i % (sizeof(kAlphanumerics) - 1)]));
+  }
+  if (aStopIndex < kMaxLength) {
+    text[aStopIndex] = aStop;
+  }
+
+  for (uint32_t length = 0; length <= kMaxLength; ++length) {
+    ASSERT_EQ(mozilla::SSE2::CountAlphanumerics(text.Elements(), length),
+              CountAlphanumericsScalar(text.Elements(), length))
+        << "stop " << uint32_t(aStop) << " at " << aStopIndex << ", length "
+        << length;
+  }
+}
+
+TEST(DOM_Base_LineBreakerSSE2, CountAlphanumerics8)
+{
+  if (!mozilla::supports_sse2()) {
+    return;
+  }
+
+  // Neighbours of the alphanumeric ranges, NUL, and bytes whose low bits
+  // match a letter once the case bit is folded in.
+  const uint8_t stops[] = {0x00, '/', ':', '@', '[', '`', '{',
+                           0x7F, 0x80, 0xC1, 0xE1, 0xFF};
+  for (uint8_t stop : stops) {
+    // Indices in the first and second half of a 16-byte block, on its last
+    // byte, in the scalar tail and past the end of the text.
+    for (uint32_t index = 0; index <= 48; ++index) {
+      CheckStopAt<uint8_t>(stop, index);
+    }
+  }
+}
+
+TEST(DOM_Base_LineBreakerSSE2, CountAlphanumerics16)
+{
+  if (!mozilla::supports_sse2()) {
+    return;
+  }
+
+  // Around the U+00FF/U+0100 boundary where the pack starts to saturate,
+  // characters whose low byte is a letter or digit (U+0130, U+0141,
+  // U+FF41), and values from U+8000 that saturate to 0x00 instead of 0xFF.
+  const char16_t stops[] = {0x0000, u'/',   u':',   u'@',   u'[',
+                            u'`',   u'{',   0x007F, 0x00C1, 0x00FF,
+                            0x0100, 0x0130, 0x0141, 0x7FFF, 0x8000,
+                            0x8041, 0xFF41, 0xFFFF};
+  for (char16_t stop : stops) {
+    // Indices in the low lane (0-7) and high lane (8-15) of each block, in
+    // the scalar tail and past the end of the text.
+    for (uint32_t index = 0; index <= 48; ++index) {
+      CheckStopAt<char16_t>(stop, index);
+    }
+  }
+}
+
+#endif  // MOZILLA_MAY_SUPPORT_SSE2
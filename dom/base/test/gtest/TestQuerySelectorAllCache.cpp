@@ -0,0 +1,165 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/Document.h"
+#include "mozilla/dom/Element.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/NullPrincipal.h"
+#include "nsGkAtoms.h"
+#include "nsHTMLDocument.h"
+#include "nsINodeList.h"
+#include "nsNetUtil.h"
+
+using mozilla::ErrorResult;
+using mozilla::NullPrincipal;
+using namespace mozilla::dom;
+
+// Builds <html><body><div></div></body></html> in a standards mode
+// HTML document and returns the div.
+static already_AddRefed<Element> SetUpQueryRoot(RefPtr<Document>& aDoc) {
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "about:blank");
+  nsCOMPtr<nsIPrincipal> principal =
+      NullPrincipal::CreateWithoutOriginAttributes();
+  RefPtr<Document> doc;
+  nsresult rv = NS_NewDOMDocument(getter_AddRefs(doc),
+                                  EmptyString(),  // aNamespaceURI
+                                  EmptyString(),  // aQualifiedName
+                                  nullptr,        // aDoctype
+                                  uri, uri, principal,
+                                  false,    // aLoadedAsData
+                                  nullptr,  // aEventObject
+                                  DocumentFlavorHTML);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return nullptr;
+  }
+
+  doc->AsHTMLDocument()->SetCompatibilityMode(eCompatibility_FullStandards);
+
+  ErrorResult error;
+  RefPtr<Element> html = doc->CreateHTMLElement(nsGkAtoms::html);
+  RefPtr<Element> body = doc->CreateHTMLElement(nsGkAtoms::body);
+  RefPtr<Element> root = doc->CreateHTMLElement(nsGkAtoms::div);
+  doc->AppendChild(*html, error);
+  html->AppendChild(*body, error);
+  body->AppendChild(*root, error);
+  if (NS_WARN_IF(error.Failed())) {
+    error.SuppressException();
+    return nullptr;
+  }
+
+  aDoc = doc;
+  return root.forget();
+}
+
+static uint32_t CountMatches(nsINode& aRoot, const char16_t* aSelector) {
+  ErrorResult error;
+  nsCOMPtr<nsINodeList> list =
+      aRoot.QuerySelectorAll(nsDependentString(aSelector), error);
+  if (NS_WARN_IF(error.Failed())) {
+    error.SuppressException();
+    return UINT32_MAX;
+  }
+  return list->Length();
+}
+
+static bool IsQueryCached(Document& aDoc, nsINode& aRoot,
+                          const char16_t* aSelector) {
+  return !!aDoc.GetQuerySelectorAllCache().Get(
+      &aRoot, nsDependentString(aSelector), aDoc.GetDOMGeneration());
+}
+
+TEST(DOM_Base_QuerySelectorAllCache, ChildListMutations)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> root = SetUpQueryRoot(doc);
+  ASSERT_TRUE(root);
+
+  ASSERT_EQ(CountMatches(*root, u"span"), 0u);
+  ASSERT_TRUE(IsQueryCached(*doc, *root, u"span"));
+  ASSERT_EQ(CountMatches(*root, u"span"), 0u);
+
+  ErrorResult error;
+  RefPtr<Element> span = doc->CreateHTMLElement(nsGkAtoms::span);
+  root->AppendChild(*span, error);
+  ASSERT_FALSE(error.Failed());
+  ASSERT_FALSE(IsQueryCached(*doc, *root, u"span"));
+  ASSERT_EQ(CountMatches(*root, u"span"), 1u);
+
+  root->RemoveChild(*span, error);
+  ASSERT_FALSE(error.Failed());
+  ASSERT_EQ(CountMatches(*root, u"span"), 0u);
+}
+
+TEST(DOM_Base_QuerySelectorAllCache, ClassAndIdChanges)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> root = SetUpQueryRoot(doc);
+  ASSERT_TRUE(root);
+
+  ErrorResult error;
+  RefPtr<Element> span = doc->CreateHTMLElement(nsGkAtoms::span);
+  root->AppendChild(*span, error);
+  ASSERT_FALSE(error.Failed());
+
+  ASSERT_EQ(CountMatches(*root, u".foo"), 0u);
+  ASSERT_EQ(CountMatches(*root, u"#bar"), 0u);
+
+  span->SetAttribute(NS_LITERAL_STRING("class"), NS_LITERAL_STRING("foo"),
+                     error);
+  ASSERT_FALSE(error.Failed());
+  ASSERT_EQ(CountMatches(*root, u".foo"), 1u);
+  ASSERT_EQ(CountMatches(*root, u"#bar"), 0u);
+
+  span->SetAttribute(NS_LITERAL_STRING("id"), NS_LITERAL_STRING("bar"), error);
+  ASSERT_FALSE(error.Failed());
+  ASSERT_EQ(CountMatches(*root, u"#bar"), 1u);
+
+  span->RemoveAttribute(NS_LITERAL_STRING("class"), error);
+  ASSERT_FALSE(error.Failed());
+  ASSERT_EQ(CountMatches(*root, u".foo"), 0u);
+  ASSERT_EQ(CountMatches(*root, u"#bar"), 1u);
+}
+
+TEST(DOM_Base_QuerySelectorAllCache, QuirksModeSwitch)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> root = SetUpQueryRoot(doc);
+  ASSERT_TRUE(root);
+
+  ErrorResult error;
+  RefPtr<Element> span = doc->CreateHTMLElement(nsGkAtoms::span);
+  span->SetAttribute(NS_LITERAL_STRING("class"), NS_LITERAL_STRING("Foo"),
+                     error);
+  root->AppendChild(*span, error);
+  ASSERT_FALSE(error.Failed());
+
+  // Class selectors are case-sensitive in standards mode only.
+  ASSERT_EQ(CountMatches(*root, u".foo"), 0u);
+  doc->AsHTMLDocument()->SetCompatibilityMode(eCompatibility_NavQuirks);
+  ASSERT_EQ(CountMatches(*root, u".foo"), 1u);
+  doc->AsHTMLDocument()->SetCompatibilityMode(eCompatibility_FullStandards);
+  ASSERT_EQ(CountMatches(*root, u".foo"), 0u);
+}
+
+TEST(DOM_Base_QuerySelectorAllCache, PseudoClassesBypassCache)
+{
+  RefPtr<Document> doc;
+  RefPtr<Element> root = SetUpQueryRoot(doc);
+  ASSERT_TRUE(root);
+
+  ErrorResult error;
+  RefPtr<Element> first = doc->CreateHTMLElement(nsGkAtoms::span);
+  RefPtr<Element> second = doc->CreateHTMLElement(nsGkAtoms::span);
+  root->AppendChild(*first, error);
+  root->AppendChild(*second, error);
+  ASSERT_FALSE(error.Failed());
+
+  ASSERT_EQ(CountMatches(*root, u"span:first-child"), 1u);
+  ASSERT_FALSE(IsQueryCached(*doc, *root, u"span:first-child"));
+
+  ASSERT_EQ(CountMatches(*root, u"span"), 2u);
+  ASSERT_TRUE(IsQueryCached(*doc, *root, u"span"));
+}
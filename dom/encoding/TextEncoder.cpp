@@ -3,10 +3,14 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "mozilla/dom/TextEncoder.h"
+#include "js/ArrayBuffer.h"  // JS::NewArrayBufferWithContents
 #include "mozilla/CheckedInt.h"
+#include "mozilla/Unused.h"
 #include "mozilla/UniquePtrExtensions.h"
 #include "nsReadableUtils.h"
 
+#include <algorithm>
+
 namespace mozilla {
 namespace dom {
 
@@ -28,7 +32,10 @@ void TextEncoder::Encode(JSContext* aCx, JS::Handle<JSObject*> aObj,
     return;
   }
 
-  auto data = mozilla::MakeUniqueFallible<uint8_t[]>(bufLen.value());
+  // Encode straight into memory the ArrayBuffer can adopt, so that large
+  // strings don't pay for a second copy into the typed array.
+  UniquePtr<uint8_t[], JS::FreePolicy> data(js_pod_arena_malloc<uint8_t>(
+      js::ArrayBufferContentsArena, std::max<uint32_t>(bufLen.value(), 1)));
   if (!data) {
     aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
     return;
@@ -38,8 +45,29 @@ void TextEncoder::Encode(JSContext* aCx, JS::Handle<JSObject*> aObj,
       aString, MakeSpan(reinterpret_cast<char*>(data.get()), bufLen.value()));
   MOZ_ASSERT(utf8Len <= bufLen.value());
 
+  // Give back the worst-case slack. Shrinking can't really fail, but keep
+  // the original allocation if it does.
+  if (utf8Len != bufLen.value()) {
+    uint8_t* shrunk = js_pod_arena_realloc<uint8_t>(
+        js::ArrayBufferContentsArena, data.get(), bufLen.value(),
+        std::max<size_t>(utf8Len, 1));
+    if (shrunk) {
+      Unused << data.release();
+      data.reset(shrunk);
+    }
+  }
+
   JSAutoRealm ar(aCx, aObj);
-  JSObject* outView = Uint8Array::Create(aCx, utf8Len, data.get());
+  JS::Rooted<JSObject*> buffer(
+      aCx, JS::NewArrayBufferWithContents(aCx, utf8Len, data.get()));
+  if (!buffer) {
+    aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+  // The ArrayBuffer owns the data now.
+  Unused << data.release();
+
+  JSObject* outView = JS_NewUint8ArrayWithBuffer(aCx, buffer, 0, -1);
   if (!outView) {
     aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
     return;
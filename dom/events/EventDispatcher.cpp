@@ -636,12 +636,17 @@ void EventTargetChainItem::HandleEventTargetChain(
   }
 }
 
-static nsTArray<EventTargetChainItem>* sCachedMainThreadChain = nullptr;
+// Chain storage reused by main thread dispatches.  There is more than one
+// so that events dispatched from within another dispatch (from listeners or
+// default handlers) don't have to allocate a fresh chain each time.
+static const uint32_t kMaxCachedMainThreadChains = 4;
+static nsTArray<nsTArray<EventTargetChainItem>>* sCachedMainThreadChains =
+    nullptr;
 
 /* static */
 void EventDispatcher::Shutdown() {
-  delete sCachedMainThreadChain;
-  sCachedMainThreadChain = nullptr;
+  delete sCachedMainThreadChains;
+  sCachedMainThreadChains = nullptr;
 }
 
 EventTargetChainItem* EventTargetChainItemForChromeTarget(
@@ -839,10 +844,13 @@ nsresult EventDispatcher::Dispatch(nsISupports* aTarget,
   ELMCreationDetector cd;
   nsTArray<EventTargetChainItem> chain;
   if (cd.IsMainThread()) {
-    if (!sCachedMainThreadChain) {
-      sCachedMainThreadChain = new nsTArray<EventTargetChainItem>();
+    if (!sCachedMainThreadChains) {
+      sCachedMainThreadChains = new nsTArray<nsTArray<EventTargetChainItem>>();
+    }
+    if (!sCachedMainThreadChains->IsEmpty()) {
+      chain.SwapElements(sCachedMainThreadChains->LastElement());
+      sCachedMainThreadChains->RemoveLastElement();
     }
-    chain.SwapElements(*sCachedMainThreadChain);
     chain.SetCapacity(128);
   }
 
@@ -1105,9 +1113,10 @@ nsresult EventDispatcher::Dispatch(nsISupports* aTarget,
     *aEventStatus = preVisitor.mEventStatus;
   }
 
-  if (cd.IsMainThread() && chain.Capacity() == 128 && sCachedMainThreadChain) {
+  if (cd.IsMainThread() && chain.Capacity() == 128 && sCachedMainThreadChains &&
+      sCachedMainThreadChains->Length() < kMaxCachedMainThreadChains) {
     chain.ClearAndRetainStorage();
-    chain.SwapElements(*sCachedMainThreadChain);
+    sCachedMainThreadChains->AppendElement()->SwapElements(chain);
   }
 
   return rv;
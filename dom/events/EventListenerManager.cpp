@@ -6,6 +6,7 @@
 #undef CreateEvent
 
 #include "mozilla/BasicEvents.h"
+#include "mozilla/ClearOnShutdown.h"
 #include "mozilla/CycleCollectedJSRuntime.h"
 #include "mozilla/DOMEventTargetHelper.h"
 #include "mozilla/EventDispatcher.h"
@@ -17,6 +18,7 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/PresShell.h"
+#include "mozilla/StaticPtr.h"
 #include "mozilla/dom/BindingUtils.h"
 #include "mozilla/dom/Element.h"
 #include "mozilla/dom/Event.h"
@@ -31,6 +33,7 @@
 #include "mozilla/TimeStamp.h"
 
 #include "EventListenerService.h"
+#include "nsClassHashtable.h"
 #include "nsCOMPtr.h"
 #include "nsContentUtils.h"
 #include "nsDOMCID.h"
@@ -52,6 +55,8 @@
 #include "nsIFrame.h"
 #include "nsDisplayList.h"
 
+#include <algorithm>
+
 namespace mozilla {
 
 using namespace dom;
@@ -120,7 +125,8 @@ EventListenerManagerBase::EventListenerManagerBase()
       mMayHaveInputOrCompositionEventListener(false),
       mMayHaveSelectionChangeEventListener(false),
       mClearingListeners(false),
-      mIsMainThreadELM(NS_IsMainThread()) {
+      mIsMainThreadELM(NS_IsMainThread()),
+      mHasListenerRanges(false) {
   static_assert(sizeof(EventListenerManagerBase) == sizeof(uint32_t),
                 "Keep the size of EventListenerManagerBase size compact!");
 }
@@ -146,6 +152,7 @@ EventListenerManager::~EventListenerManager() {
   //             from right here, if not previously called?
   NS_ASSERTION(!mTarget, "didn't call Disconnect");
   RemoveAllListenersSilently();
+  InvalidateListenerRanges();
 }
 
 void EventListenerManager::RemoveAllListenersSilently() {
@@ -154,6 +161,7 @@ void EventListenerManager::RemoveAllListenersSilently() {
   }
   mClearingListeners = true;
   mListeners.Clear();
+  InvalidateListenerRanges();
   mClearingListeners = false;
 }
 
@@ -240,6 +248,7 @@ void EventListenerManager::AddEventListenerInternal(
 
   mNoListenerForEvent = eVoidEvent;
   mNoListenerForEventAtom = nullptr;
+  InvalidateListenerRanges();
 
   listener =
       aAllEvents ? mListeners.InsertElementAt(0) : mListeners.AppendElement();
@@ -597,6 +606,7 @@ void EventListenerManager::RemoveEventListenerInternal(
       if (listener->mListener == aListenerHolder &&
           listener->mFlags.EqualsForRemoval(aFlags)) {
         mListeners.RemoveElementAt(i);
+        InvalidateListenerRanges();
         NotifyEventListenerRemoved(aUserType);
         if (!aAllEvents && deviceType) {
           DisableDevice(aEventMessage);
@@ -644,6 +654,103 @@ bool EventListenerManager::ListenerCanHandle(const Listener* aListener,
   return aListener->mEventMessage == aEventMessage;
 }
 
+// Managers with at most this many listeners just walk all of them.
+static const uint32_t kListenerRangeThreshold = 8;
+// Number of event types whose ranges are remembered at once.
+static const uint32_t kMaxListenerRanges = 16;
+
+struct EventListenerRange {
+  EventMessage mEventMessage;
+  RefPtr<nsAtom> mTypeAtom;
+  uint32_t mStart;
+  uint32_t mEnd;
+};
+
+typedef nsClassHashtable<nsPtrHashKey<EventListenerManager>,
+                         nsTArray<EventListenerRange>>
+    ListenerRangeTable;
+
+// Only main-thread managers get ranges. Entries are created for managers with
+// more than kListenerRangeThreshold listeners and removed whenever their
+// listeners change.
+static StaticAutoPtr<ListenerRangeTable> sListenerRanges;
+static bool sListenerRangesCreated = false;
+
+void EventListenerManager::DropListenerRanges() {
+  MOZ_ASSERT(mHasListenerRanges);
+  MOZ_ASSERT(NS_IsMainThread());
+  if (sListenerRanges) {
+    sListenerRanges->Remove(this);
+  }
+  mHasListenerRanges = false;
+}
+
+void EventListenerManager::GetListenerRange(const WidgetEvent* aEvent,
+                                            EventMessage aEventMessage,
+                                            uint32_t* aStart, uint32_t* aEnd) {
+  uint32_t count = mListeners.Length();
+  *aStart = 0;
+  *aEnd = count;
+  if (count <= kListenerRangeThreshold || !mIsMainThreadELM) {
+    return;
+  }
+
+  if (!sListenerRanges) {
+    // Don't come back after shutdown cleared the table.
+    if (sListenerRangesCreated) {
+      return;
+    }
+    sListenerRanges = new ListenerRangeTable();
+    sListenerRangesCreated = true;
+    ClearOnShutdown(&sListenerRanges);
+  }
+
+  // Mirrors ListenerCanHandle: unidentified events are matched by atom only.
+  nsAtom* typeAtom = aEvent->mMessage == eUnidentifiedEvent
+                         ? aEvent->mSpecifiedEventType.get()
+                         : nullptr;
+
+  nsTArray<EventListenerRange>* ranges = sListenerRanges->LookupOrAdd(this);
+  mHasListenerRanges = true;
+  for (const EventListenerRange& range : *ranges) {
+    if (range.mEventMessage == aEventMessage && range.mTypeAtom == typeAtom) {
+      *aStart = range.mStart;
+      *aEnd = range.mEnd;
+      return;
+    }
+  }
+
+  uint32_t start = count;
+  uint32_t end = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    const Listener* listener = &mListeners.ElementAt(i);
+    if (listener->mListenerType == Listener::eNoListener) {
+      continue;
+    }
+    if (listener->mAllEvents ||
+        (typeAtom ? listener->mTypeAtom == typeAtom
+                  : listener->mEventMessage == aEventMessage)) {
+      start = std::min(start, i);
+      end = i + 1;
+    }
+  }
+  if (start > end) {
+    start = end = 0;
+  }
+
+  if (ranges->Length() >= kMaxListenerRanges) {
+    ranges->Clear();
+  }
+  EventListenerRange* range = ranges->AppendElement();
+  range->mEventMessage = aEventMessage;
+  range->mTypeAtom = typeAtom;
+  range->mStart = start;
+  range->mEnd = end;
+
+  *aStart = start;
+  *aEnd = end;
+}
+
 static bool DefaultToPassiveTouchListeners() {
   static bool sDefaultToPassiveTouchListeners = false;
   static bool sIsPrefCached = false;
@@ -844,6 +951,7 @@ void EventListenerManager::RemoveEventHandler(nsAtom* aName) {
 
   if (listener) {
     mListeners.RemoveElementAt(uint32_t(listener - &mListeners.ElementAt(0)));
+    InvalidateListenerRanges();
     NotifyEventListenerRemoved(aName);
     if (IsDeviceType(eventMessage)) {
       DisableDevice(eventMessage);
@@ -1155,7 +1263,10 @@ void EventListenerManager::HandleEventInternal(nsPresContext* aPresContext,
   EventMessage eventMessage = aEvent->mMessage;
 
   while (true) {
-    nsAutoTObserverArray<Listener, 2>::EndLimitedIterator iter(mListeners);
+    uint32_t start, end;
+    GetListenerRange(aEvent, eventMessage, &start, &end);
+    nsAutoTObserverArray<Listener, 2>::EndLimitedIterator iter(mListeners,
+                                                               start, end);
     Maybe<EventMessageAutoOverride> legacyAutoOverride;
     while (iter.HasMore()) {
       if (aEvent->mFlags.mImmediatePropagationStopped) {
@@ -1286,6 +1397,7 @@ void EventListenerManager::HandleEventInternal(nsPresContext* aPresContext,
     mListeners.RemoveElementsBy([](const Listener& aListener) {
       return aListener.mListenerType == Listener::eNoListener;
     });
+    InvalidateListenerRanges();
     NotifyEventListenerRemoved(aEvent->mSpecifiedEventType);
     if (IsDeviceType(aEvent->mMessage)) {
       // This is a device-type event, we need to check whether we can
@@ -1591,6 +1703,12 @@ size_t EventListenerManager::SizeOfIncludingThis(
     MallocSizeOf aMallocSizeOf) const {
   size_t n = aMallocSizeOf(this);
   n += mListeners.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  if (mHasListenerRanges && sListenerRanges) {
+    if (nsTArray<EventListenerRange>* ranges =
+            sListenerRanges->Get(const_cast<EventListenerManager*>(this))) {
+      n += ranges->ShallowSizeOfIncludingThis(aMallocSizeOf);
+    }
+  }
   uint32_t count = mListeners.Length();
   for (uint32_t i = 0; i < count; ++i) {
     JSEventHandler* jsEventHandler =
@@ -1712,6 +1830,7 @@ void EventListenerManager::RemoveAllListeners() {
     RefPtr<nsAtom> type = mListeners.ElementAt(idx).mTypeAtom;
     EventMessage message = mListeners.ElementAt(idx).mEventMessage;
     mListeners.RemoveElementAt(idx);
+    InvalidateListenerRanges();
     NotifyEventListenerRemoved(type);
     if (IsDeviceType(message)) {
       DisableDevice(message);
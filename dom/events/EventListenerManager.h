@@ -155,7 +155,8 @@ class EventListenerManagerBase {
   uint16_t mMayHaveSelectionChangeEventListener : 1;
   uint16_t mClearingListeners : 1;
   uint16_t mIsMainThreadELM : 1;
-  // uint16_t mUnused : 4;
+  uint16_t mHasListenerRanges : 1;
+  // uint16_t mUnused : 3;
 };
 
 /*
@@ -599,6 +600,30 @@ class EventListenerManager final : public EventListenerManagerBase {
   bool ListenerCanHandle(const Listener* aListener, const WidgetEvent* aEvent,
                          EventMessage aEventMessage) const;
 
+  /**
+   * Returns the range of mListeners which can contain listeners for aEvent
+   * (using aEventMessage).  Listeners outside it never match, so
+   * HandleEventInternal only needs to walk the range.
+   *
+   * The ranges of main-thread managers with many listeners are remembered
+   * per event type in a table outside the manager, so that managers don't
+   * grow; mHasListenerRanges says whether this one has an entry there.  A
+   * range is the span from the first to the last listener that can match, so
+   * it only helps when listeners of the same type were added next to each
+   * other: with types registered in interleaved order (a, b, a, b, ...) the
+   * span of each type covers the others and nothing is skipped.
+   */
+  void GetListenerRange(const WidgetEvent* aEvent, EventMessage aEventMessage,
+                        uint32_t* aStart, uint32_t* aEnd);
+
+  void InvalidateListenerRanges() {
+    if (mHasListenerRanges) {
+      DropListenerRanges();
+    }
+  }
+
+  void DropListenerRanges();
+
   // BE AWARE, a lot of instances of EventListenerManager will be created.
   // Therefor, we need to keep this class compact.  When you add integer
   // members, please add them to EventListemerManagerBase and check the size
@@ -17,9 +17,13 @@
 #include "mozilla/dom/WorkerRunnable.h"
 #include "mozilla/dom/WorkerScope.h"
 #include "mozilla/ipc/PBackgroundSharedTypes.h"
+#include "nsIAsyncInputStream.h"
 #include "nsIInputStreamPump.h"
 #include "nsIThreadRetargetableRequest.h"
 #include "nsProxyRelease.h"
+#include "nsStreamUtils.h"
+
+#include <algorithm>
 
 // Undefine the macro of CreateFile to avoid FileCreatorHelper#CreateFile being
 // replaced by FileCreatorHelper#CreateFileW.
@@ -281,6 +285,173 @@ NS_INTERFACE_MAP_END
 
 }  // anonymous
 
+/*
+ * Reads a non-blob body to completion on the worker thread which owns the
+ * FetchBodyConsumer, so that consuming it needs neither the main-thread pump
+ * nor a runnable to bring the result back. Blocking streams are turned into
+ * async ones by NS_MakeAsyncNonBlockingInputStream and read on a stream
+ * transport thread behind a pipe.
+ */
+template <class Derived>
+class ConsumeBodyWorkerReader final : public nsIInputStreamCallback {
+ public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  ConsumeBodyWorkerReader(FetchBodyConsumer<Derived>* aFetchBodyConsumer,
+                          nsIAsyncInputStream* aStream,
+                          nsIEventTarget* aTarget,
+                          ThreadSafeWorkerRef* aWorkerRef)
+      : mFetchBodyConsumer(aFetchBodyConsumer),
+        mStream(aStream),
+        mTarget(aTarget),
+        mWorkerRef(aWorkerRef),
+        mBuffer(nullptr),
+        mLength(0),
+        mCapacity(0) {
+    MOZ_ASSERT(aFetchBodyConsumer);
+    MOZ_ASSERT(aStream);
+    MOZ_ASSERT(aTarget);
+    MOZ_ASSERT(aWorkerRef);
+  }
+
+  nsresult Start() { return mStream->AsyncWait(this, 0, 0, mTarget); }
+
+  void Cancel() {
+    mFetchBodyConsumer = nullptr;
+    mWorkerRef = nullptr;
+    mStream->CloseWithStatus(NS_BINDING_ABORTED);
+  }
+
+  NS_IMETHOD
+  OnInputStreamReady(nsIAsyncInputStream* aStream) override {
+    // Canceled by the worker shutting down or by an abort signal.
+    if (!mFetchBodyConsumer) {
+      return NS_OK;
+    }
+
+    for (;;) {
+      uint64_t available = 0;
+      nsresult rv = mStream->Available(&available);
+      if (rv == NS_BASE_STREAM_CLOSED) {
+        Finish(NS_OK);
+        return NS_OK;
+      }
+      if (NS_WARN_IF(NS_FAILED(rv))) {
+        Finish(rv);
+        return NS_OK;
+      }
+
+      if (NS_WARN_IF(!EnsureCapacity(available))) {
+        Finish(NS_ERROR_OUT_OF_MEMORY);
+        return NS_OK;
+      }
+
+      uint32_t read = 0;
+      rv = mStream->Read(reinterpret_cast<char*>(mBuffer) + mLength,
+                         mCapacity - mLength, &read);
+      if (rv == NS_BASE_STREAM_WOULD_BLOCK) {
+        rv = mStream->AsyncWait(this, 0, 0, mTarget);
+        if (NS_WARN_IF(NS_FAILED(rv))) {
+          Finish(rv);
+        }
+        return NS_OK;
+      }
+      if (rv == NS_BASE_STREAM_CLOSED || (NS_SUCCEEDED(rv) && read == 0)) {
+        Finish(NS_OK);
+        return NS_OK;
+      }
+      if (NS_WARN_IF(NS_FAILED(rv))) {
+        Finish(rv);
+        return NS_OK;
+      }
+
+      mLength += read;
+    }
+  }
+
+ private:
+  ~ConsumeBodyWorkerReader() { free(mBuffer); }
+
+  // Makes room for at least aAvailable more bytes, growing geometrically.
+  // The result is handed to ContinueConsumeBody, which takes a uint32_t
+  // length, so larger bodies fail the same way the stream loader does.
+  bool EnsureCapacity(uint64_t aAvailable) {
+    const uint32_t kMinChunk = 4096;
+
+    uint64_t needed =
+        uint64_t(mLength) + std::max(aAvailable, uint64_t(kMinChunk));
+    if (needed <= mCapacity) {
+      return true;
+    }
+
+    if (mLength == UINT32_MAX) {
+      return false;
+    }
+
+    uint64_t capacity = std::max(needed, uint64_t(mCapacity) * 2);
+    capacity = std::min(capacity, uint64_t(UINT32_MAX));
+
+    uint8_t* buffer = static_cast<uint8_t*>(realloc(mBuffer, capacity));
+    if (!buffer) {
+      return false;
+    }
+
+    mBuffer = buffer;
+    mCapacity = uint32_t(capacity);
+    return true;
+  }
+
+  void Finish(nsresult aStatus) {
+    RefPtr<FetchBodyConsumer<Derived>> consumer = mFetchBodyConsumer.forget();
+    RefPtr<ThreadSafeWorkerRef> workerRef = mWorkerRef.forget();
+
+    consumer->NullifyConsumeBodyReader();
+
+    // An empty stream that was already closed never grew the buffer, but
+    // ContinueConsumeBody expects one even for a zero-length body.
+    if (NS_SUCCEEDED(aStatus) && !mBuffer) {
+      mBuffer = static_cast<uint8_t*>(malloc(1));
+      if (NS_WARN_IF(!mBuffer)) {
+        aStatus = NS_ERROR_OUT_OF_MEMORY;
+      }
+    }
+
+    // The buffer grew geometrically. arrayBuffer() adopts it as is, so give
+    // back the slack rather than keeping up to twice the body alive.
+    if (NS_SUCCEEDED(aStatus) && mLength && mLength < mCapacity) {
+      if (uint8_t* buffer = static_cast<uint8_t*>(realloc(mBuffer, mLength))) {
+        mBuffer = buffer;
+        mCapacity = mLength;
+      }
+    }
+
+    uint8_t* result = mBuffer;
+    mBuffer = nullptr;
+
+    // ContinueConsumeBody takes ownership of the data.
+    consumer->ContinueConsumeBody(aStatus, mLength, result);
+  }
+
+  RefPtr<FetchBodyConsumer<Derived>> mFetchBodyConsumer;
+  nsCOMPtr<nsIAsyncInputStream> mStream;
+  nsCOMPtr<nsIEventTarget> mTarget;
+  RefPtr<ThreadSafeWorkerRef> mWorkerRef;
+
+  uint8_t* mBuffer;
+  uint32_t mLength;
+  uint32_t mCapacity;
+};
+
+template <class Derived>
+NS_IMPL_ADDREF(ConsumeBodyWorkerReader<Derived>)
+template <class Derived>
+NS_IMPL_RELEASE(ConsumeBodyWorkerReader<Derived>)
+template <class Derived>
+NS_INTERFACE_MAP_BEGIN(ConsumeBodyWorkerReader<Derived>)
+NS_INTERFACE_MAP_ENTRY(nsIInputStreamCallback)
+    NS_INTERFACE_MAP_ENTRY_AMBIGUOUS(nsISupports, nsIInputStreamCallback)
+NS_INTERFACE_MAP_END
+
 template <class Derived>
 /* static */ already_AddRefed<Promise> FetchBodyConsumer<Derived>::Create(
     nsIGlobalObject* aGlobal, nsIEventTarget* aMainThreadEventTarget,
@@ -305,8 +476,16 @@ template <class Derived>
     MOZ_ASSERT(workerPrivate);
 
     RefPtr<StrongWorkerRef> strongWorkerRef = StrongWorkerRef::Create(
-        workerPrivate, "FetchBodyConsumer",
-        [consumer]() { consumer->ShutDownMainThreadConsuming(); });
+        workerPrivate, "FetchBodyConsumer", [consumer]() {
+          // A body read directly by the worker has nothing pending on the
+          // main-thread, so we can release the consumer right away.
+          if (consumer->CancelWorkerConsuming()) {
+            consumer->ContinueConsumeBody(NS_BINDING_ABORTED, 0, nullptr,
+                                          true /* shutting down */);
+            return;
+          }
+          consumer->ShutDownMainThreadConsuming();
+        });
     if (NS_WARN_IF(!strongWorkerRef)) {
       aRv.Throw(NS_ERROR_FAILURE);
       return nullptr;
@@ -331,11 +510,21 @@ template <class Derived>
     }
   }
 
-  nsCOMPtr<nsIRunnable> r =
-      new BeginConsumeBodyRunnable<Derived>(consumer, workerRef);
-  aRv = aMainThreadEventTarget->Dispatch(r.forget(), NS_DISPATCH_NORMAL);
-  if (NS_WARN_IF(aRv.Failed())) {
-    return nullptr;
+  // Blobs need the main-thread for blob URLs, local files and
+  // MutableBlobStorage. Everything else can be read by the worker itself,
+  // which keeps worker fetches independent of main-thread responsiveness.
+  if (workerRef && aType != CONSUME_BLOB) {
+    aRv = consumer->BeginConsumeBodyWorker(workerRef);
+    if (NS_WARN_IF(aRv.Failed())) {
+      return nullptr;
+    }
+  } else {
+    nsCOMPtr<nsIRunnable> r =
+        new BeginConsumeBodyRunnable<Derived>(consumer, workerRef);
+    aRv = aMainThreadEventTarget->Dispatch(r.forget(), NS_DISPATCH_NORMAL);
+    if (NS_WARN_IF(aRv.Failed())) {
+      return nullptr;
+    }
   }
 
   if (aSignalImpl) {
@@ -621,6 +810,54 @@ void FetchBodyConsumer<Derived>::BeginConsumeBodyMainThread(
   }
 }
 
+/*
+ * BeginConsumeBodyWorker() starts reading the body on the worker thread which
+ * owns the consumer. Unlike BeginConsumeBodyMainThread(), it runs before the
+ * consume promise is handed out, so failures are simply returned to Create().
+ */
+template <class Derived>
+nsresult FetchBodyConsumer<Derived>::BeginConsumeBodyWorker(
+    ThreadSafeWorkerRef* aWorkerRef) {
+  AssertIsOnTargetThread();
+  MOZ_ASSERT(aWorkerRef);
+  MOZ_ASSERT(mConsumeType != CONSUME_BLOB);
+
+  nsCOMPtr<nsIAsyncInputStream> asyncStream;
+  nsresult rv = NS_MakeAsyncNonBlockingInputStream(
+      mBodyStream.forget(), getter_AddRefs(asyncStream));
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return rv;
+  }
+
+  RefPtr<ConsumeBodyWorkerReader<Derived>> reader =
+      new ConsumeBodyWorkerReader<Derived>(
+          this, asyncStream, mGlobal->EventTargetFor(TaskCategory::Other),
+          aWorkerRef);
+
+  rv = reader->Start();
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    reader->Cancel();
+    return rv;
+  }
+
+  mConsumeBodyReader = reader;
+  return NS_OK;
+}
+
+template <class Derived>
+bool FetchBodyConsumer<Derived>::CancelWorkerConsuming() {
+  AssertIsOnTargetThread();
+
+  if (!mConsumeBodyReader) {
+    return false;
+  }
+
+  RefPtr<ConsumeBodyWorkerReader<Derived>> reader =
+      mConsumeBodyReader.forget();
+  reader->Cancel();
+  return true;
+}
+
 /*
  * OnBlobResult() is called when a blob body is ready to be consumed (when its
  * network transfer completes in BeginConsumeBodyRunnable or its local File has
@@ -877,7 +1114,9 @@ NS_IMETHODIMP FetchBodyConsumer<Derived>::Observe(nsISupports* aSubject,
 template <class Derived>
 void FetchBodyConsumer<Derived>::Abort() {
   AssertIsOnTargetThread();
-  ShutDownMainThreadConsuming();
+  if (!CancelWorkerConsuming()) {
+    ShutDownMainThreadConsuming();
+  }
   ContinueConsumeBody(NS_ERROR_DOM_ABORT_ERR, 0, nullptr);
 }
 
@@ -22,6 +22,9 @@ class ThreadSafeWorkerRef;
 template <class Derived>
 class FetchBody;
 
+template <class Derived>
+class ConsumeBodyWorkerReader;
+
 // FetchBody is not thread-safe but we need to move it around threads.  In order
 // to keep it alive all the time, we use a ThreadSafeWorkerRef, if created on
 // workers.
@@ -42,6 +45,8 @@ class FetchBodyConsumer final : public nsIObserver,
 
   void BeginConsumeBodyMainThread(ThreadSafeWorkerRef* aWorkerRef);
 
+  nsresult BeginConsumeBodyWorker(ThreadSafeWorkerRef* aWorkerRef);
+
   void OnBlobResult(Blob* aBlob, ThreadSafeWorkerRef* aWorkerRef = nullptr);
 
   void ContinueConsumeBody(nsresult aStatus, uint32_t aLength, uint8_t* aResult,
@@ -59,6 +64,10 @@ class FetchBodyConsumer final : public nsIObserver,
     mConsumeBodyPump = nullptr;
   }
 
+  bool CancelWorkerConsuming();
+
+  void NullifyConsumeBodyReader() { mConsumeBodyReader = nullptr; }
+
   // AbortFollower
   void Abort() override;
 
@@ -96,6 +105,10 @@ class FetchBodyConsumer final : public nsIObserver,
   // Touched on the main-thread only.
   nsCOMPtr<nsIInputStreamPump> mConsumeBodyPump;
 
+  // Used instead of mConsumeBodyPump when a worker reads the body itself.
+  // Touched on the target thread only.
+  RefPtr<ConsumeBodyWorkerReader<Derived>> mConsumeBodyReader;
+
   // Only ever set once, always on target thread.
   FetchConsumeType mConsumeType;
   RefPtr<Promise> mConsumePromise;
@@ -0,0 +1,37 @@
+const EXPECTED_LENGTH = 5 * (65536 + 17);
+
+function checkBytes(bytes) {
+  if (bytes.length != EXPECTED_LENGTH) {
+    return "wrong length " + bytes.length;
+  }
+  for (let i = 0; i < bytes.length; ++i) {
+    if (bytes[i] != i % 251) {
+      return "wrong byte at " + i;
+    }
+  }
+  return "ok";
+}
+
+async function run() {
+  let response = await fetch("file_chunked_body.sjs");
+  let buffer = await response.arrayBuffer();
+  postMessage({
+    what: "arrayBuffer",
+    result: checkBytes(new Uint8Array(buffer)),
+  });
+
+  response = await fetch("file_chunked_body.sjs");
+  let blob = await response.blob();
+  let blobBuffer = await new Response(blob).arrayBuffer();
+  postMessage({ what: "blob", result: checkBytes(new Uint8Array(blobBuffer)) });
+
+  response = await fetch("file_chunked_body.sjs");
+  let text = await response.text();
+  // Bytes 0x80 and up are not valid UTF-8 on their own, so only the length of
+  // the decoded text is meaningful here.
+  postMessage({ what: "text", result: text.length > 0 ? "ok" : "empty" });
+
+  postMessage({ what: "done" });
+}
+
+run().catch(e => postMessage({ what: "error", result: String(e) }));
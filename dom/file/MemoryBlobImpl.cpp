@@ -3,13 +3,72 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "MemoryBlobImpl.h"
+#include "mozilla/dom/MutableBlobStorage.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/SHA1.h"
+#include "mozilla/Unused.h"
+#include "File.h"
 #include "nsPrintfCString.h"
+#include "nsThreadUtils.h"
+
+// In KB.
+#define BLOB_MEMORY_BUDGET 262144
+
+// Smaller buffers are never moved to a temporary file.
+#define BLOB_MEMORY_MIN_SPILL 1048576
 
 namespace mozilla {
 namespace dom {
 
+namespace {
+
+// Copies the buffer of a DataOwner to a temporary file through a
+// MutableBlobStorage and hands the resulting file-backed BlobImpl back to the
+// DataOwner.
+class DataOwnerSpiller final : public MutableBlobStorageCallback {
+ public:
+  NS_INLINE_DECL_REFCOUNTING(DataOwnerSpiller, override)
+
+  explicit DataOwnerSpiller(MemoryBlobImpl::DataOwner* aDataOwner)
+      : mDataOwner(aDataOwner) {
+    MOZ_ASSERT(aDataOwner);
+  }
+
+  void Start() {
+    MOZ_ASSERT(NS_IsMainThread());
+
+    RefPtr<MutableBlobStorage> storage =
+        new MutableBlobStorage(MutableBlobStorage::eCouldBeInTemporaryFile);
+    nsresult rv = storage->AppendDataOwner(mDataOwner);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      mDataOwner->SpillFailed();
+      return;
+    }
+
+    storage->GetBlobWhenReady(nullptr, EmptyCString(), this);
+  }
+
+  void BlobStoreCompleted(MutableBlobStorage* aBlobStorage, Blob* aBlob,
+                          nsresult aRv) override {
+    MOZ_ASSERT(NS_IsMainThread());
+
+    if (NS_FAILED(aRv) || !aBlob) {
+      mDataOwner->SpillFailed();
+      return;
+    }
+
+    mDataOwner->SpillCompleted(aBlob->Impl());
+  }
+
+ private:
+  ~DataOwnerSpiller() {}
+
+  RefPtr<MemoryBlobImpl::DataOwner> mDataOwner;
+};
+
+}  // anonymous namespace
+
 NS_IMPL_ADDREF(MemoryBlobImpl::DataOwnerAdapter)
 NS_IMPL_RELEASE(MemoryBlobImpl::DataOwnerAdapter)
 
@@ -29,6 +88,8 @@ nsresult MemoryBlobImpl::DataOwnerAdapter::Create(DataOwner* aDataOwner,
                                                   nsIInputStream** _retval) {
   nsresult rv;
   MOZ_ASSERT(aDataOwner, "Uh ...");
+  DataOwner::sDataOwnerMutex.AssertCurrentThreadOwns();
+  MOZ_ASSERT(aDataOwner->mData);
 
   nsCOMPtr<nsIInputStream> stream;
 
@@ -38,6 +99,9 @@ nsresult MemoryBlobImpl::DataOwnerAdapter::Create(DataOwner* aDataOwner,
       NS_ASSIGNMENT_DEPEND);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  // Released by ~DataOwnerAdapter.
+  ++aDataOwner->mMemoryStreams;
+
   NS_ADDREF(*_retval =
                 new MemoryBlobImpl::DataOwnerAdapter(aDataOwner, stream));
 
@@ -59,8 +123,140 @@ void MemoryBlobImpl::CreateInputStream(nsIInputStream** aStream,
     return;
   }
 
-  aRv = MemoryBlobImpl::DataOwnerAdapter::Create(mDataOwner, mStart, mLength,
-                                                 aStream);
+  aRv = mDataOwner->CreateInputStream(mStart, mLength, aStream);
+}
+
+bool MemoryBlobImpl::IsSpilling() const {
+  StaticMutexAutoLock lock(DataOwner::sDataOwnerMutex);
+  return mDataOwner->mSpilling;
+}
+
+bool MemoryBlobImpl::IsSpilled() const {
+  StaticMutexAutoLock lock(DataOwner::sDataOwnerMutex);
+  return !!mDataOwner->mSpilledBlobImpl;
+}
+
+nsresult MemoryBlobImpl::DataOwner::CreateInputStream(
+    uint64_t aStart, uint64_t aLength, nsIInputStream** aStream) {
+  RefPtr<BlobImpl> spilledBlobImpl;
+
+  {
+    StaticMutexAutoLock lock(sDataOwnerMutex);
+
+    // As long as the buffer is around, reading it is cheaper than going
+    // through the temporary file.
+    if (mData) {
+      return MemoryBlobImpl::DataOwnerAdapter::Create(this, aStart, aLength,
+                                                      aStream);
+    }
+
+    spilledBlobImpl = mSpilledBlobImpl;
+  }
+
+  MOZ_ASSERT(spilledBlobImpl);
+
+  ErrorResult rv;
+  RefPtr<BlobImpl> slice =
+      spilledBlobImpl->CreateSlice(aStart, aLength, EmptyString(), rv);
+  if (NS_WARN_IF(rv.Failed())) {
+    return rv.StealNSResult();
+  }
+
+  slice->CreateInputStream(aStream, rv);
+  return rv.StealNSResult();
+}
+
+void MemoryBlobImpl::DataOwner::FreeData() {
+  sDataOwnerMutex.AssertCurrentThreadOwns();
+  MOZ_ASSERT(mData);
+  MOZ_ASSERT(sTotalLength >= mLength);
+
+  sTotalLength -= mLength;
+  free(mData);
+  mData = nullptr;
+}
+
+void MemoryBlobImpl::DataOwner::MemoryStreamReleased() {
+  StaticMutexAutoLock lock(sDataOwnerMutex);
+  MOZ_ASSERT(mMemoryStreams);
+
+  if (!--mMemoryStreams && mSpilledBlobImpl && mData) {
+    FreeData();
+  }
+}
+
+/* static */
+uint64_t MemoryBlobImpl::DataOwner::MemoryBudget() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // The pref is in KB.
+  return uint64_t(
+             Preferences::GetUint("dom.blob.memoryBudget", BLOB_MEMORY_BUDGET)) *
+         1024;
+}
+
+void MemoryBlobImpl::DataOwner::MaybeSpill() {
+  // Slices are created by CreateInputStream() from 32-bit offsets, and
+  // MutableBlobStorage does not go further either.
+  if (mLength < BLOB_MEMORY_MIN_SPILL || mLength > UINT32_MAX) {
+    return;
+  }
+
+  // The budget is checked on the main thread, where the temporary file can be
+  // requested.
+  RefPtr<DataOwner> self = this;
+  nsCOMPtr<nsIRunnable> r =
+      NS_NewRunnableFunction("MemoryBlobImpl::DataOwner::MaybeSpill",
+                             [self]() { self->SpillIfOverBudget(); });
+  Unused << NS_DispatchToMainThread(r.forget());
+}
+
+void MemoryBlobImpl::DataOwner::SpillIfOverBudget() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  uint64_t budget = MemoryBudget();
+  if (!budget) {
+    return;
+  }
+
+  {
+    StaticMutexAutoLock lock(sDataOwnerMutex);
+
+    // Nobody else holds the buffer anymore, or it's already on its way.
+    if (mRefCnt == 1 || !mData || mSpilling || mSpilledBlobImpl ||
+        sTotalLength <= budget) {
+      return;
+    }
+
+    mSpilling = true;
+  }
+
+  RefPtr<DataOwnerSpiller> spiller = new DataOwnerSpiller(this);
+  spiller->Start();
+}
+
+void MemoryBlobImpl::DataOwner::SpillCompleted(BlobImpl* aBlobImpl) {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(aBlobImpl);
+  MOZ_ASSERT(aBlobImpl->GetSize(IgnoreErrors()) == mLength);
+
+  StaticMutexAutoLock lock(sDataOwnerMutex);
+  MOZ_ASSERT(mSpilling);
+
+  mSpilling = false;
+  mSpilledBlobImpl = aBlobImpl;
+
+  if (!mMemoryStreams && mData) {
+    FreeData();
+  }
+}
+
+void MemoryBlobImpl::DataOwner::SpillFailed() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // We keep using the buffer.
+  StaticMutexAutoLock lock(sDataOwnerMutex);
+  mSpilling = false;
 }
 
 /* static */
@@ -72,6 +268,15 @@ StaticMutex MemoryBlobImpl::DataOwner::sDataOwnerMutex;
 /* static */
 bool MemoryBlobImpl::DataOwner::sMemoryReporterRegistered = false;
 
+/* static */
+uint64_t MemoryBlobImpl::DataOwner::sTotalLength = 0;
+
+/* static */
+uint64_t MemoryBlobImpl::DataOwner::TotalLength() {
+  StaticMutexAutoLock lock(sDataOwnerMutex);
+  return sTotalLength;
+}
+
 MOZ_DEFINE_MALLOC_SIZE_OF(MemoryFileDataOwnerMallocSizeOf)
 
 class MemoryBlobImplDataOwnerMemoryReporter final : public nsIMemoryReporter {
@@ -95,6 +300,11 @@ class MemoryBlobImplDataOwnerMemoryReporter final : public nsIMemoryReporter {
 
     for (DataOwner* owner = DataOwner::sDataOwners->getFirst(); owner;
          owner = owner->getNext()) {
+      // This buffer has been moved to a temporary file.
+      if (!owner->mData) {
+        continue;
+      }
+
       size_t size = MemoryFileDataOwnerMallocSizeOf(owner->mData);
 
       if (size < LARGE_OBJECT_MIN_SIZE) {
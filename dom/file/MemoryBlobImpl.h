@@ -28,6 +28,7 @@ class MemoryBlobImpl final : public BaseBlobImpl {
                      aLength, aLastModifiedDate),
         mDataOwner(new DataOwner(aMemoryBuffer, aLength)) {
     MOZ_ASSERT(mDataOwner && mDataOwner->mData, "must have data");
+    mDataOwner->MaybeSpill();
   }
 
   MemoryBlobImpl(void* aMemoryBuffer, uint64_t aLength,
@@ -36,6 +37,7 @@ class MemoryBlobImpl final : public BaseBlobImpl {
                      aLength),
         mDataOwner(new DataOwner(aMemoryBuffer, aLength)) {
     MOZ_ASSERT(mDataOwner && mDataOwner->mData, "must have data");
+    mDataOwner->MaybeSpill();
   }
 
   virtual void CreateInputStream(nsIInputStream** aStream,
@@ -48,6 +50,11 @@ class MemoryBlobImpl final : public BaseBlobImpl {
 
   virtual bool IsMemoryFile() const override { return true; }
 
+  // Whether the data is being copied to a temporary file, and whether it has
+  // been. Meant for tests.
+  bool IsSpilling() const;
+  bool IsSpilled() const;
+
   size_t GetAllocationSize() const override { return mLength; }
 
   size_t GetAllocationSize(
@@ -59,7 +66,10 @@ class MemoryBlobImpl final : public BaseBlobImpl {
    public:
     NS_INLINE_DECL_THREADSAFE_REFCOUNTING(DataOwner)
     DataOwner(void* aMemoryBuffer, uint64_t aLength)
-        : mData(aMemoryBuffer), mLength(aLength) {
+        : mData(aMemoryBuffer),
+          mLength(aLength),
+          mMemoryStreams(0),
+          mSpilling(false) {
       mozilla::StaticMutexAutoLock lock(sDataOwnerMutex);
 
       if (!sDataOwners) {
@@ -67,6 +77,7 @@ class MemoryBlobImpl final : public BaseBlobImpl {
         EnsureMemoryReporterRegistered();
       }
       sDataOwners->insertBack(this);
+      sTotalLength += mLength;
     }
 
    private:
@@ -80,21 +91,58 @@ class MemoryBlobImpl final : public BaseBlobImpl {
         sDataOwners = nullptr;
       }
 
-      free(mData);
+      if (mData) {
+        FreeData();
+      }
     }
 
+    void FreeData();
+
    public:
     static void EnsureMemoryReporterRegistered();
 
+    // Returns the number of bytes currently owned by all the DataOwners of
+    // this process. This can be called on any thread.
+    static uint64_t TotalLength();
+
+    // Returns the value of the "dom.blob.memoryBudget" pref in bytes, 0 if
+    // there is no budget. Main-thread only.
+    static uint64_t MemoryBudget();
+
+    // If this buffer is large enough and the memory blobs of this process
+    // are over budget, starts copying the data to a temporary file. Once
+    // that is done, new streams read from the file and the buffer is freed
+    // as soon as the streams created before are gone.
+    void MaybeSpill();
+    void SpillIfOverBudget();
+    void SpillCompleted(BlobImpl* aBlobImpl);
+    void SpillFailed();
+
+    // Creates a stream for the given range, either over the buffer or over
+    // the temporary file.
+    nsresult CreateInputStream(uint64_t aStart, uint64_t aLength,
+                               nsIInputStream** aStream);
+
+    // Called by the DataOwnerAdapters created over mData when they go away.
+    void MemoryStreamReleased();
+
     // sDataOwners and sMemoryReporterRegistered may only be accessed while
     // holding sDataOwnerMutex!  You also must hold the mutex while touching
     // elements of the linked list that DataOwner inherits from.
     static mozilla::StaticMutex sDataOwnerMutex;
     static mozilla::StaticAutoPtr<mozilla::LinkedList<DataOwner> > sDataOwners;
     static bool sMemoryReporterRegistered;
+    static uint64_t sTotalLength;
 
+    // mData is set to null once it has been moved to a temporary file and the
+    // last stream reading from it is gone. mData, mSpilledBlobImpl,
+    // mMemoryStreams and mSpilling are protected by sDataOwnerMutex.
     void* mData;
     uint64_t mLength;
+
+    RefPtr<BlobImpl> mSpilledBlobImpl;
+    uint32_t mMemoryStreams;
+    bool mSpilling;
   };
 
   class DataOwnerAdapter final : public nsIInputStream,
@@ -120,7 +168,7 @@ class MemoryBlobImpl final : public BaseBlobImpl {
     NS_FORWARD_NSIIPCSERIALIZABLEINPUTSTREAM(mSerializableInputStream->)
 
    private:
-    ~DataOwnerAdapter() {}
+    ~DataOwnerAdapter() { mDataOwner->MemoryStreamReleased(); }
 
     DataOwnerAdapter(DataOwner* aDataOwner, nsIInputStream* aStream)
         : mDataOwner(aDataOwner),
@@ -145,7 +193,7 @@ class MemoryBlobImpl final : public BaseBlobImpl {
       : BaseBlobImpl(NS_LITERAL_STRING("MemoryBlobImpl"), aContentType,
                      aOther->mStart + aStart, aLength),
         mDataOwner(aOther->mDataOwner) {
-    MOZ_ASSERT(mDataOwner && mDataOwner->mData, "must have data");
+    MOZ_ASSERT(mDataOwner, "must have data");
     mImmutable = aOther->mImmutable;
   }
 
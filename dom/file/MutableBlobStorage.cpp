@@ -18,6 +18,7 @@
 #include "nsProxyRelease.h"
 
 #define BLOB_MEMORY_TEMPORARY_FILE 1048576
+#define BLOB_MEMORY_MIN_SPILL 65536
 
 namespace mozilla {
 namespace dom {
@@ -115,6 +116,23 @@ class WriteRunnable final : public Runnable {
     return new WriteRunnable(aBlobStorage, aData, aLength);
   }
 
+  // The buffer of a MemoryBlobImpl is not copied: the DataOwner keeps it alive
+  // until the data is written.
+  static WriteRunnable* ShareBuffer(MutableBlobStorage* aBlobStorage,
+                                    MemoryBlobImpl::DataOwner* aDataOwner) {
+    MOZ_ASSERT(NS_IsMainThread());
+    MOZ_ASSERT(aBlobStorage);
+    MOZ_ASSERT(aDataOwner);
+    MOZ_ASSERT(aDataOwner->mData);
+    MOZ_ASSERT(aDataOwner->mLength <= UINT32_MAX);
+
+    WriteRunnable* runnable =
+        new WriteRunnable(aBlobStorage, aDataOwner->mData,
+                          static_cast<uint32_t>(aDataOwner->mLength));
+    runnable->mDataOwner = aDataOwner;
+    return runnable;
+  }
+
   NS_IMETHOD
   Run() override {
     MOZ_ASSERT(!NS_IsMainThread());
@@ -126,12 +144,21 @@ class WriteRunnable final : public Runnable {
       return NS_OK;
     }
 
-    int32_t written = PR_Write(fd, mData, mLength);
-    if (NS_WARN_IF(written < 0 || uint32_t(written) != mLength)) {
-      mBlobStorage->CloseFD();
-      return mBlobStorage->EventTarget()->Dispatch(
-          new ErrorPropagationRunnable(mBlobStorage, NS_ERROR_FAILURE),
-          NS_DISPATCH_NORMAL);
+    // PR_Write() takes a signed length.
+    const char* data = static_cast<const char*>(mData);
+    uint32_t left = mLength;
+    while (left) {
+      int32_t toWrite = std::min<uint32_t>(left, INT32_MAX);
+      int32_t written = PR_Write(fd, data, toWrite);
+      if (NS_WARN_IF(written != toWrite)) {
+        mBlobStorage->CloseFD();
+        return mBlobStorage->EventTarget()->Dispatch(
+            new ErrorPropagationRunnable(mBlobStorage, NS_ERROR_FAILURE),
+            NS_DISPATCH_NORMAL);
+      }
+
+      data += written;
+      left -= written;
     }
 
     return NS_OK;
@@ -147,9 +174,14 @@ class WriteRunnable final : public Runnable {
     MOZ_ASSERT(aData);
   }
 
-  ~WriteRunnable() { free(mData); }
+  ~WriteRunnable() {
+    if (!mDataOwner) {
+      free(mData);
+    }
+  }
 
   RefPtr<MutableBlobStorage> mBlobStorage;
+  RefPtr<MemoryBlobImpl::DataOwner> mDataOwner;
   void* mData;
   uint32_t mLength;
 };
@@ -297,7 +329,8 @@ MutableBlobStorage::MutableBlobStorage(MutableBlobStorageType aType,
       mFD(nullptr),
       mErrorResult(NS_OK),
       mEventTarget(aEventTarget),
-      mMaxMemory(aMaxMemory) {
+      mMaxMemory(aMaxMemory),
+      mMaxTotalMemory(0) {
   MOZ_ASSERT(NS_IsMainThread());
 
   if (!mEventTarget) {
@@ -309,6 +342,10 @@ MutableBlobStorage::MutableBlobStorage(MutableBlobStorageType aType,
                                       BLOB_MEMORY_TEMPORARY_FILE);
   }
 
+  if (aType == eCouldBeInTemporaryFile) {
+    mMaxTotalMemory = MemoryBlobImpl::DataOwner::MemoryBudget();
+  }
+
   MOZ_ASSERT(mEventTarget);
 }
 
@@ -453,6 +490,28 @@ nsresult MutableBlobStorage::Append(const void* aData, uint32_t aLength) {
   return NS_OK;
 }
 
+nsresult MutableBlobStorage::AppendDataOwner(
+    MemoryBlobImpl::DataOwner* aDataOwner) {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(aDataOwner);
+
+  MutexAutoLock lock(mMutex);
+  MOZ_ASSERT(mStorageState == eInMemory);
+  MOZ_ASSERT(!mDataLen);
+  MOZ_ASSERT(!mPendingDataOwner);
+
+  // The buffer is written as soon as the temporary file exists.
+  mPendingDataOwner = aDataOwner;
+  mDataLen = aDataOwner->mLength;
+
+  if (!MaybeCreateTemporaryFile(lock)) {
+    mPendingDataOwner = nullptr;
+    return NS_ERROR_FAILURE;
+  }
+
+  return NS_OK;
+}
+
 bool MutableBlobStorage::ExpandBufferSize(const MutexAutoLock& aProofOfLock,
                                           uint64_t aSize) {
   MOZ_ASSERT(mStorageState < eInTemporaryFile);
@@ -495,7 +554,18 @@ bool MutableBlobStorage::ShouldBeTemporaryStorage(
     return false;
   }
 
-  return bufferSize.value() >= mMaxMemory;
+  if (bufferSize.value() >= mMaxMemory) {
+    return true;
+  }
+
+  // Small appends don't deserve a temporary file, whatever the budget says.
+  if (!mMaxTotalMemory || bufferSize.value() < BLOB_MEMORY_MIN_SPILL) {
+    return false;
+  }
+
+  CheckedUint64 totalSize = MemoryBlobImpl::DataOwner::TotalLength();
+  totalSize += bufferSize.value();
+  return !totalSize.isValid() || totalSize.value() >= mMaxTotalMemory;
 }
 
 bool MutableBlobStorage::MaybeCreateTemporaryFile(
@@ -575,14 +645,20 @@ void MutableBlobStorage::TemporaryFileCreated(PRFileDesc* aFD) {
   mFD = aFD;
   MOZ_ASSERT(NS_SUCCEEDED(mErrorResult));
 
-  // This runnable takes the ownership of mData and it will write this buffer
-  // into the temporary file.
-  RefPtr<WriteRunnable> runnable =
-      WriteRunnable::AdoptBuffer(this, mData, mDataLen);
+  RefPtr<WriteRunnable> runnable;
+  if (mPendingDataOwner) {
+    // AppendDataOwner() doesn't go through mData.
+    MOZ_ASSERT(!mData);
+    runnable = WriteRunnable::ShareBuffer(this, mPendingDataOwner);
+    mPendingDataOwner = nullptr;
+  } else {
+    // This runnable takes the ownership of mData and it will write this
+    // buffer into the temporary file.
+    runnable = WriteRunnable::AdoptBuffer(this, mData, mDataLen);
+    mData = nullptr;
+  }
   MOZ_ASSERT(runnable);
 
-  mData = nullptr;
-
   nsresult rv = DispatchToIOThread(runnable.forget());
   if (NS_WARN_IF(NS_FAILED(rv))) {
     // Shutting down, we cannot continue.
@@ -5,6 +5,7 @@
 #ifndef mozilla_dom_MutableBlobStorage_h
 #define mozilla_dom_MutableBlobStorage_h
 
+#include "mozilla/dom/MemoryBlobImpl.h"
 #include "mozilla/RefPtr.h"
 #include "mozilla/Mutex.h"
 #include "nsCOMPtr.h"
@@ -50,6 +51,11 @@ class MutableBlobStorage final {
 
   nsresult Append(const void* aData, uint32_t aLength);
 
+  // Moves the whole buffer of aDataOwner to the temporary file without copying
+  // it. This must be the only data of this storage, and can only be used
+  // with eCouldBeInTemporaryFile. Main-thread only.
+  nsresult AppendDataOwner(MemoryBlobImpl::DataOwner* aDataOwner);
+
   // This method can be called just once.
   // The callback will be called when the Blob is ready.
   void GetBlobWhenReady(nsISupports* aParent, const nsACString& aContentType,
@@ -121,11 +127,20 @@ class MutableBlobStorage final {
 
   RefPtr<TemporaryIPCBlobChild> mActor;
 
+  // Set by AppendDataOwner() until the temporary file is created.
+  RefPtr<MemoryBlobImpl::DataOwner> mPendingDataOwner;
+
   // This value is used when we go from eInMemory to eWaitingForTemporaryFile
   // and eventually eInTemporaryFile. If the size of the buffer is >=
   // mMaxMemory, the creation of the temporary file will start.
   // It's not used if mStorageState is eKeepInMemory.
   uint32_t mMaxMemory;
+
+  // Process-wide budget for the memory blobs. When the data already kept in
+  // MemoryBlobImpls plus our buffer reaches this value, we migrate to a
+  // temporary file even if mMaxMemory has not been reached yet. 0 means no
+  // budget.
+  uint64_t mMaxTotalMemory;
 };
 
 }  // namespace dom
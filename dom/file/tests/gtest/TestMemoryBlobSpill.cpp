@@ -0,0 +1,156 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/MemoryBlobImpl.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/SpinEventLoopUntil.h"
+#include "nsIInputStream.h"
+#include "nsStreamUtils.h"
+#include "nsString.h"
+
+using namespace mozilla;
+using namespace mozilla::dom;
+
+// Large enough to be spilled.
+static const uint32_t kSpillBlobSize = 2 * 1024 * 1024;
+
+// Puts the memory blobs of the process over budget as soon as there is one
+// that can be spilled, for the lifetime of the object.
+class MOZ_RAII AutoTinyBlobBudget final {
+ public:
+  AutoTinyBlobBudget() {
+    // The pref is in KB; 0 would disable the budget.
+    Preferences::SetUint("dom.blob.memoryBudget", 1);
+  }
+  ~AutoTinyBlobBudget() { Preferences::ClearUser("dom.blob.memoryBudget"); }
+};
+
+static already_AddRefed<MemoryBlobImpl> CreateSpillableBlob() {
+  char* data = static_cast<char*>(moz_xmalloc(kSpillBlobSize));
+  for (uint32_t i = 0; i < kSpillBlobSize; ++i) {
+    data[i] = char(i % 251);
+  }
+  RefPtr<MemoryBlobImpl> blobImpl =
+      new MemoryBlobImpl(data, kSpillBlobSize, EmptyString());
+  return blobImpl.forget();
+}
+
+static bool HasSpillableBlobContent(const nsACString& aData) {
+  if (aData.Length() != kSpillBlobSize) {
+    return false;
+  }
+  for (uint32_t i = 0; i < kSpillBlobSize; ++i) {
+    if (aData[i] != char(i % 251)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static nsresult ReadBlob(BlobImpl* aBlobImpl, nsACString& aData) {
+  ErrorResult rv;
+  nsCOMPtr<nsIInputStream> stream;
+  aBlobImpl->CreateInputStream(getter_AddRefs(stream), rv);
+  if (NS_WARN_IF(rv.Failed())) {
+    return rv.StealNSResult();
+  }
+  return NS_ConsumeStream(stream, UINT32_MAX, aData);
+}
+
+TEST(DOM_File_MemoryBlobSpill, OverBudget)
+{
+  AutoTinyBlobBudget budget;
+  uint64_t totalBefore = MemoryBlobImpl::DataOwner::TotalLength();
+
+  RefPtr<MemoryBlobImpl> blobImpl = CreateSpillableBlob();
+  ASSERT_EQ(MemoryBlobImpl::DataOwner::TotalLength(),
+            totalBefore + kSpillBlobSize);
+  ASSERT_FALSE(blobImpl->IsSpilled());
+
+  // With no stream open on the buffer, it is freed as soon as the data is in
+  // the temporary file.
+  SpinEventLoopUntil([&]() { return blobImpl->IsSpilled(); });
+  ASSERT_EQ(MemoryBlobImpl::DataOwner::TotalLength(), totalBefore);
+
+  nsAutoCString data;
+  ASSERT_EQ(ReadBlob(blobImpl, data), NS_OK);
+  ASSERT_TRUE(HasSpillableBlobContent(data));
+
+  // Slices read from the file too.
+  ErrorResult rv;
+  RefPtr<BlobImpl> slice = blobImpl->CreateSlice(10, 100, EmptyString(), rv);
+  ASSERT_FALSE(rv.Failed());
+  nsAutoCString sliceData;
+  ASSERT_EQ(ReadBlob(slice, sliceData), NS_OK);
+  ASSERT_TRUE(sliceData.Equals(Substring(data, 10, 100)));
+}
+
+TEST(DOM_File_MemoryBlobSpill, ReadWhileSpilling)
+{
+  AutoTinyBlobBudget budget;
+  uint64_t totalBefore = MemoryBlobImpl::DataOwner::TotalLength();
+
+  RefPtr<MemoryBlobImpl> blobImpl = CreateSpillableBlob();
+
+  // This stream reads the buffer, which must outlive the spill.
+  ErrorResult rv;
+  nsCOMPtr<nsIInputStream> memoryStream;
+  blobImpl->CreateInputStream(getter_AddRefs(memoryStream), rv);
+  ASSERT_FALSE(rv.Failed());
+
+  char head[16];
+  uint32_t read = 0;
+  ASSERT_EQ(memoryStream->Read(head, sizeof(head), &read), NS_OK);
+  ASSERT_EQ(read, sizeof(head));
+
+  SpinEventLoopUntil([&]() { return blobImpl->IsSpilled(); });
+  ASSERT_EQ(MemoryBlobImpl::DataOwner::TotalLength(),
+            totalBefore + kSpillBlobSize);
+
+  nsAutoCString rest;
+  ASSERT_EQ(NS_ConsumeStream(memoryStream, UINT32_MAX, rest), NS_OK);
+  nsAutoCString data(head, sizeof(head));
+  data.Append(rest);
+  ASSERT_TRUE(HasSpillableBlobContent(data));
+
+  // New streams read the temporary file.
+  nsAutoCString fileData;
+  ASSERT_EQ(ReadBlob(blobImpl, fileData), NS_OK);
+  ASSERT_TRUE(HasSpillableBlobContent(fileData));
+
+  // The buffer goes away with the last stream reading it.
+  memoryStream = nullptr;
+  ASSERT_EQ(MemoryBlobImpl::DataOwner::TotalLength(), totalBefore);
+}
+
+TEST(DOM_File_MemoryBlobSpill, ReleasedWhileSpilling)
+{
+  AutoTinyBlobBudget budget;
+  uint64_t totalBefore = MemoryBlobImpl::DataOwner::TotalLength();
+
+  RefPtr<MemoryBlobImpl> blobImpl = CreateSpillableBlob();
+  SpinEventLoopUntil(
+      [&]() { return blobImpl->IsSpilling() || blobImpl->IsSpilled(); });
+
+  // The spiller keeps the DataOwner alive until the copy is done.
+  blobImpl = nullptr;
+  SpinEventLoopUntil([&]() {
+    return MemoryBlobImpl::DataOwner::TotalLength() == totalBefore;
+  });
+}
+
+TEST(DOM_File_MemoryBlobSpill, ReleasedBeforeSpilling)
+{
+  AutoTinyBlobBudget budget;
+  uint64_t totalBefore = MemoryBlobImpl::DataOwner::TotalLength();
+
+  // The blob goes away before the main thread gets to check the budget, so
+  // there is nothing to spill.
+  RefPtr<MemoryBlobImpl> blobImpl = CreateSpillableBlob();
+  blobImpl = nullptr;
+  NS_ProcessPendingEvents(nullptr);
+  ASSERT_EQ(MemoryBlobImpl::DataOwner::TotalLength(), totalBefore);
+}
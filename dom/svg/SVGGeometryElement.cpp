@@ -38,9 +38,8 @@ nsresult SVGGeometryElement::AfterSetAttr(int32_t aNamespaceID, nsAtom* aName,
                                           const nsAttrValue* aOldValue,
                                           nsIPrincipal* aSubjectPrincipal,
                                           bool aNotify) {
-  if (mCachedPath && aNamespaceID == kNameSpaceID_None &&
-      AttributeDefinesGeometry(aName)) {
-    mCachedPath = nullptr;
+  if (aNamespaceID == kNameSpaceID_None && AttributeDefinesGeometry(aName)) {
+    ClearAnyCachedPath();
   }
   return SVGGeometryElementBase::AfterSetAttr(
       aNamespaceID, aName, aValue, aOldValue, aSubjectPrincipal, aNotify);
@@ -83,21 +82,40 @@ bool SVGGeometryElement::IsMarkable() { return false; }
 
 void SVGGeometryElement::GetMarkPoints(nsTArray<SVGMark>* aMarks) {}
 
+// Enough for the content backend plus the reference draw target used for
+// bounds and hit-testing (e.g. D2D and cairo on Windows), or for an element
+// used both as a shape and in a clipPath with a different fill rule.
+#define MAX_CACHED_PATHS 2
+
+static bool IsCacheablePathBackend(BackendType aBackend) {
+  // Paths created by recording or capture draw targets are tied to that
+  // target, so only cache paths of the backends we paint and measure with.
+  return aBackend == gfxPlatform::GetPlatform()->GetDefaultContentBackend() ||
+         aBackend == BackendType::SKIA || aBackend == BackendType::CAIRO;
+}
+
 already_AddRefed<Path> SVGGeometryElement::GetOrBuildPath(
     const DrawTarget* aDrawTarget, FillRule aFillRule) {
-  // We only cache the path if it matches the backend used for screen painting:
-  bool cacheable = aDrawTarget->GetBackendType() ==
-                   gfxPlatform::GetPlatform()->GetDefaultContentBackend();
-
-  if (cacheable && mCachedPath && mCachedPath->GetFillRule() == aFillRule &&
-      aDrawTarget->GetBackendType() == mCachedPath->GetBackendType()) {
-    RefPtr<Path> path(mCachedPath);
-    return path.forget();
+  BackendType backend = aDrawTarget->GetBackendType();
+  for (uint32_t i = 0; i < mCachedPaths.Length(); ++i) {
+    if (mCachedPaths[i]->GetFillRule() == aFillRule &&
+        mCachedPaths[i]->GetBackendType() == backend) {
+      RefPtr<Path> path(mCachedPaths[i]);
+      if (i != 0) {
+        mCachedPaths.RemoveElementAt(i);
+        mCachedPaths.InsertElementAt(0, path);
+      }
+      return path.forget();
+    }
   }
+
   RefPtr<PathBuilder> builder = aDrawTarget->CreatePathBuilder(aFillRule);
   RefPtr<Path> path = BuildPath(builder);
-  if (cacheable) {
-    mCachedPath = path;
+  if (path && IsCacheablePathBackend(backend)) {
+    if (mCachedPaths.Length() >= MAX_CACHED_PATHS) {
+      mCachedPaths.RemoveLastElement();
+    }
+    mCachedPaths.InsertElementAt(0, path);
   }
   return path.forget();
 }
@@ -105,7 +123,8 @@ already_AddRefed<Path> SVGGeometryElement::GetOrBuildPath(
 already_AddRefed<Path> SVGGeometryElement::GetOrBuildPathForMeasuring() {
   RefPtr<DrawTarget> drawTarget =
       gfxPlatform::GetPlatform()->ScreenReferenceDrawTarget();
-  FillRule fillRule = mCachedPath ? mCachedPath->GetFillRule() : GetFillRule();
+  FillRule fillRule =
+      mCachedPaths.IsEmpty() ? GetFillRule() : mCachedPaths[0]->GetFillRule();
   return GetOrBuildPath(drawTarget, fillRule);
 }
 
@@ -7,6 +7,7 @@
 
 #include "mozilla/dom/SVGGraphicsElement.h"
 #include "mozilla/gfx/2D.h"
+#include "mozilla/Maybe.h"
 #include "SVGAnimatedNumber.h"
 #include "nsISVGPoint.h"
 
@@ -58,10 +59,24 @@ class SVGGeometryElement : public SVGGeometryElementBase {
   bool IsNodeOfType(uint32_t aFlags) const override;
 
   /**
-   * Causes this element to discard any Path object that GetOrBuildPath may
-   * have cached.
+   * Causes this element to discard any Path objects that GetOrBuildPath may
+   * have cached, along with any cached path bounds.
    */
-  void ClearAnyCachedPath() final { mCachedPath = nullptr; }
+  void ClearAnyCachedPath() final {
+    mCachedPaths.Clear();
+    mCachedPathBounds.reset();
+  }
+
+  /**
+   * The user space bounds of this element's path, as last computed by
+   * SVGGeometryFrame::GetBBoxContribution. These only depend on the
+   * element's geometry, so they stay valid across transform and paint
+   * changes and are dropped together with the cached paths.
+   */
+  const Maybe<Rect>& GetCachedPathBounds() const { return mCachedPathBounds; }
+  void SetCachedPathBounds(const Rect& aBounds) {
+    mCachedPathBounds = Some(aBounds);
+  }
 
   virtual bool AttributeDefinesGeometry(const nsAtom* aName);
 
@@ -217,7 +232,10 @@ class SVGGeometryElement : public SVGGeometryElementBase {
 
   SVGAnimatedNumber mPathLength;
   static NumberInfo sNumberInfo;
-  mutable RefPtr<Path> mCachedPath;
+  // Paths for the backends and fill rules we were asked for, most recently
+  // used first. See GetOrBuildPath.
+  mutable AutoTArray<RefPtr<Path>, 1> mCachedPaths;
+  Maybe<Rect> mCachedPathBounds;
 };
 
 }  // namespace dom
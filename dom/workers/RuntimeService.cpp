@@ -74,6 +74,7 @@
 #endif
 
 #include "Principal.h"
+#include "ScriptLoader.h"
 #include "WorkerDebuggerManager.h"
 #include "WorkerError.h"
 #include "WorkerLoadInfo.h"
@@ -1854,6 +1855,8 @@ void RuntimeService::Cleanup() {
 
   NS_ASSERTION(!mWindowMap.Count(), "All windows should have been released!");
 
+  workerinternals::ClearScriptBytecodeCache();
+
   if (mObserved) {
     if (NS_FAILED(Preferences::UnregisterPrefixCallback(
             LoadContextOptions, PREF_JS_OPTIONS_PREFIX)) ||
@@ -2203,6 +2206,7 @@ RuntimeService::Observe(nsISupports* aSubject, const char* aTopic,
     GarbageCollectAllWorkers(/* shrinking = */ true);
     CycleCollectAllWorkers();
     MemoryPressureAllWorkers();
+    workerinternals::ClearScriptBytecodeCache();
     return NS_OK;
   }
   if (!strcmp(aTopic, NS_IOSERVICE_OFFLINE_STATUS_TOPIC)) {
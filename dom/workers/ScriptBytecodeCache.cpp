@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ScriptBytecodeCache.h"
+
+#include "mozilla/UniquePtr.h"
+#include "nsIMemoryReporter.h"
+
+namespace mozilla {
+namespace dom {
+namespace workerinternals {
+
+class ScriptBytecodeCache::Reporter final : public nsIMemoryReporter {
+  ~Reporter() {}
+
+ public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
+                            nsISupports* aData, bool aAnonymize) override {
+    MOZ_COLLECT_REPORT(
+        "explicit/workers/bytecode-cache", KIND_HEAP, UNITS_BYTES,
+        ScriptBytecodeCache::SizeOfIncludingThis(MallocSizeOf),
+        "Memory used by the bytecode of the scripts shared between workers.");
+    return NS_OK;
+  }
+
+ private:
+  MOZ_DEFINE_MALLOC_SIZE_OF(MallocSizeOf)
+};
+
+NS_IMPL_ISUPPORTS(ScriptBytecodeCache::Reporter, nsIMemoryReporter)
+
+StaticMutex ScriptBytecodeCache::sMutex;
+StaticAutoPtr<nsClassHashtable<nsStringHashKey, ScriptBytecodeCache::Entry>>
+    ScriptBytecodeCache::sEntries;
+StaticAutoPtr<LinkedList<ScriptBytecodeCache::Entry>> ScriptBytecodeCache::sLRU;
+size_t ScriptBytecodeCache::sTotalSize = 0;
+bool ScriptBytecodeCache::sReporterRegistered = false;
+
+/* static */
+void ScriptBytecodeCache::ComputeDigest(const char16_t* aSource,
+                                        size_t aLength, Digest& aDigest) {
+  SHA1Sum sha1;
+  sha1.update(aSource, aLength * sizeof(char16_t));
+  sha1.finish(aDigest);
+}
+
+/* static */
+bool ScriptBytecodeCache::Lookup(const nsAString& aURL, const Digest& aDigest,
+                                 JS::TranscodeBuffer& aBytecode) {
+  StaticMutexAutoLock lock(sMutex);
+
+  if (!sEntries) {
+    return false;
+  }
+
+  Entry* entry = sEntries->Get(aURL);
+  if (!entry || memcmp(entry->mDigest, aDigest, sizeof(Digest)) != 0) {
+    return false;
+  }
+
+  // Most recently used entries live at the end of the list.
+  entry->remove();
+  sLRU->insertBack(entry);
+
+  return aBytecode.appendAll(entry->mBytecode);
+}
+
+/* static */
+void ScriptBytecodeCache::Store(const nsAString& aURL, const Digest& aDigest,
+                                bool aServiceWorker,
+                                JS::TranscodeBuffer&& aBytecode) {
+  StaticMutexAutoLock lock(sMutex);
+
+  if (aBytecode.length() > kMaxSize) {
+    return;
+  }
+
+  if (!sEntries) {
+    sEntries = new nsClassHashtable<nsStringHashKey, Entry>();
+    sLRU = new LinkedList<Entry>();
+
+    if (!sReporterRegistered) {
+      RegisterStrongMemoryReporter(new Reporter());
+      sReporterRegistered = true;
+    }
+  }
+
+  if (Entry* entry = sEntries->Get(aURL)) {
+    // The script changed: drop the stale bytecode.
+    RemoveEntry(entry);
+  }
+
+  // Evict the least recently used regular entries first.
+  EvictOldest(aBytecode, /* aServiceWorker */ false);
+  if (aServiceWorker) {
+    EvictOldest(aBytecode, /* aServiceWorker */ true);
+  }
+
+  if (!HasRoomFor(aBytecode)) {
+    return;
+  }
+
+  sTotalSize += aBytecode.length();
+
+  auto entry = MakeUnique<Entry>();
+  entry->mURL = aURL;
+  memcpy(entry->mDigest, aDigest, sizeof(Digest));
+  entry->mServiceWorker = aServiceWorker;
+  entry->mBytecode = std::move(aBytecode);
+  sLRU->insertBack(entry.get());
+  sEntries->Put(aURL, entry.release());
+}
+
+/* static */
+void ScriptBytecodeCache::Clear() {
+  StaticMutexAutoLock lock(sMutex);
+  // The entries remove themselves from sLRU when they are deleted.
+  sEntries = nullptr;
+  sLRU = nullptr;
+  sTotalSize = 0;
+}
+
+/* static */
+uint32_t ScriptBytecodeCache::Count() {
+  StaticMutexAutoLock lock(sMutex);
+  return sEntries ? sEntries->Count() : 0;
+}
+
+/* static */
+size_t ScriptBytecodeCache::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) {
+  StaticMutexAutoLock lock(sMutex);
+
+  if (!sEntries) {
+    return 0;
+  }
+
+  size_t n = sEntries->ShallowSizeOfIncludingThis(aMallocSizeOf) +
+             aMallocSizeOf(sLRU.get());
+  for (Entry* entry = sLRU->getFirst(); entry; entry = entry->getNext()) {
+    n += aMallocSizeOf(entry);
+    n += entry->mURL.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+    n += entry->mBytecode.sizeOfExcludingThis(aMallocSizeOf);
+  }
+  return n;
+}
+
+/* static */
+bool ScriptBytecodeCache::HasRoomFor(const JS::TranscodeBuffer& aBytecode) {
+  sMutex.AssertCurrentThreadOwns();
+  return sEntries->Count() < kMaxEntries &&
+         sTotalSize + aBytecode.length() <= kMaxSize;
+}
+
+/* static */
+void ScriptBytecodeCache::EvictOldest(const JS::TranscodeBuffer& aBytecode,
+                                      bool aServiceWorker) {
+  sMutex.AssertCurrentThreadOwns();
+
+  Entry* next;
+  for (Entry* entry = sLRU->getFirst(); entry && !HasRoomFor(aBytecode);
+       entry = next) {
+    next = entry->getNext();
+    if (entry->mServiceWorker == aServiceWorker) {
+      RemoveEntry(entry);
+    }
+  }
+}
+
+/* static */
+void ScriptBytecodeCache::RemoveEntry(Entry* aEntry) {
+  sMutex.AssertCurrentThreadOwns();
+  MOZ_ASSERT(sTotalSize >= aEntry->mBytecode.length());
+  sTotalSize -= aEntry->mBytecode.length();
+  // This deletes aEntry, which takes it out of sLRU.
+  sEntries->Remove(aEntry->mURL);
+}
+
+}  // namespace workerinternals
+}  // namespace dom
+}  // namespace mozilla
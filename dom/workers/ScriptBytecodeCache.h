@@ -0,0 +1,89 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_dom_workers_ScriptBytecodeCache_h
+#define mozilla_dom_workers_ScriptBytecodeCache_h
+
+#include "js/Transcoding.h"
+#include "mozilla/LinkedList.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/SHA1.h"
+#include "mozilla/StaticMutex.h"
+#include "mozilla/StaticPtr.h"
+#include "nsClassHashtable.h"
+#include "nsHashKeys.h"
+#include "nsString.h"
+
+namespace mozilla {
+namespace dom {
+namespace workerinternals {
+
+// Process-wide cache of the bytecode of the scripts evaluated by workers. Many
+// workers running the same script (worker pools, or importScripts of a shared
+// library) decode the bytecode produced by the first one instead of compiling
+// the source again. Entries are keyed by the absolute URL of the script and
+// validated against the SHA1 of the source text, so a changed script is
+// simply compiled and re-encoded.
+// When the cache is full, the least recently used entries are evicted.
+// ServiceWorker scripts are kept in preference to the others: a regular entry
+// never evicts a ServiceWorker one, and a ServiceWorker entry only evicts the
+// oldest ServiceWorker entries once no regular entry is left. The cache lives
+// in memory only; it is not stored next to the ServiceWorkerScriptCache
+// entries, so it doesn't survive the content process.
+class ScriptBytecodeCache final {
+ public:
+  typedef uint8_t Digest[SHA1Sum::kHashSize];
+
+  static const uint32_t kMaxEntries = 64;
+  static const size_t kMaxSize = 32 * 1024 * 1024;
+
+  static void ComputeDigest(const char16_t* aSource, size_t aLength,
+                            Digest& aDigest);
+
+  // Appends the bytecode cached for aURL to aBytecode and returns true if
+  // there is some and it was encoded from a source with the given digest.
+  static bool Lookup(const nsAString& aURL, const Digest& aDigest,
+                     JS::TranscodeBuffer& aBytecode);
+
+  static void Store(const nsAString& aURL, const Digest& aDigest,
+                    bool aServiceWorker, JS::TranscodeBuffer&& aBytecode);
+
+  static void Clear();
+
+  static uint32_t Count();
+
+ private:
+  struct Entry : public LinkedListElement<Entry> {
+    nsString mURL;
+    Digest mDigest;
+    bool mServiceWorker;
+    JS::TranscodeBuffer mBytecode;
+  };
+
+  class Reporter;
+
+  static size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf);
+
+  static bool HasRoomFor(const JS::TranscodeBuffer& aBytecode);
+
+  // Removes the least recently used entries of the given kind until
+  // aBytecode fits.
+  static void EvictOldest(const JS::TranscodeBuffer& aBytecode,
+                          bool aServiceWorker);
+
+  static void RemoveEntry(Entry* aEntry);
+
+  static StaticMutex sMutex;
+  static StaticAutoPtr<nsClassHashtable<nsStringHashKey, Entry>> sEntries;
+  // All the entries of sEntries, least recently used first.
+  static StaticAutoPtr<LinkedList<Entry>> sLRU;
+  static size_t sTotalSize;
+  static bool sReporterRegistered;
+};
+
+}  // namespace workerinternals
+}  // namespace dom
+}  // namespace mozilla
+
+#endif  // mozilla_dom_workers_ScriptBytecodeCache_h
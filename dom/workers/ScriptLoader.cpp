@@ -27,6 +27,7 @@
 #include "jsfriendapi.h"
 #include "js/CompilationAndEvaluation.h"
 #include "js/SourceText.h"
+#include "js/Transcoding.h"
 #include "nsError.h"
 #include "nsContentPolicyUtils.h"
 #include "nsContentUtils.h"
@@ -70,6 +71,7 @@
 #include "mozilla/dom/ServiceWorkerManager.h"
 #include "mozilla/UniquePtr.h"
 #include "Principal.h"
+#include "ScriptBytecodeCache.h"
 #include "WorkerHolder.h"
 #include "WorkerPrivate.h"
 #include "WorkerRunnable.h"
@@ -77,8 +79,14 @@
 
 #define MAX_CONCURRENT_SCRIPTS 1000
 
+// Scripts smaller than this are compiled faster than they are encoded. This
+// doesn't apply to ServiceWorker scripts, which are compiled again every time
+// the ServiceWorker is woken up.
+#define MIN_BYTECODE_CACHE_SOURCE_LENGTH 4096
+
 using mozilla::dom::cache::Cache;
 using mozilla::dom::cache::CacheStorage;
+using mozilla::dom::workerinternals::ScriptBytecodeCache;
 using mozilla::ipc::PrincipalInfo;
 
 namespace mozilla {
@@ -86,6 +94,72 @@ namespace dom {
 
 namespace {
 
+// Evaluates the script, going through ScriptBytecodeCache when the script is
+// large enough to be worth it, or is run by a ServiceWorker.
+// Takes the ownership of aData.
+bool EvaluateWorkerScript(JSContext* aCx, const nsAString& aURL,
+                          const JS::CompileOptions& aOptions,
+                          bool aServiceWorker, char16_t* aData,
+                          size_t aDataLength) {
+  // The bytecode doesn't preserve the muted-errors flag, so cross-origin
+  // scripts are never cached.
+  bool useCache =
+      (aServiceWorker || aDataLength >= MIN_BYTECODE_CACHE_SOURCE_LENGTH) &&
+      !aOptions.mutedErrors();
+
+  ScriptBytecodeCache::Digest digest;
+  JS::Rooted<JSScript*> script(aCx);
+
+  if (useCache) {
+    ScriptBytecodeCache::ComputeDigest(aData, aDataLength, digest);
+
+    JS::TranscodeBuffer bytecode;
+    if (ScriptBytecodeCache::Lookup(aURL, digest, bytecode)) {
+      JS::TranscodeResult result = JS::DecodeScript(aCx, bytecode, &script);
+      if (result == JS::TranscodeResult_Throw) {
+        js_free(aData);
+        return false;
+      }
+
+      // On any other failure, fall back to the source.
+      if (result != JS::TranscodeResult_Ok) {
+        script = nullptr;
+      }
+    }
+  }
+
+  if (!script) {
+    JS::SourceText<char16_t> srcBuf;
+    if (!srcBuf.init(aCx, JS::UniqueTwoByteChars(aData), aDataLength)) {
+      return false;
+    }
+
+    if (!useCache) {
+      JS::Rooted<JS::Value> unused(aCx);
+      return JS::Evaluate(aCx, aOptions, srcBuf, &unused);
+    }
+
+    script = JS::Compile(aCx, aOptions, srcBuf);
+    if (!script) {
+      return false;
+    }
+
+    // Encode before running: run-once scripts cannot be encoded afterwards.
+    JS::TranscodeBuffer bytecode;
+    if (JS::EncodeScript(aCx, bytecode, script) == JS::TranscodeResult_Ok) {
+      ScriptBytecodeCache::Store(aURL, digest, aServiceWorker,
+                                 std::move(bytecode));
+    } else {
+      // Encoding failures are not fatal.
+      JS_ClearPendingException(aCx);
+    }
+  } else {
+    js_free(aData);
+  }
+
+  return JS_ExecuteScript(aCx, script);
+}
+
 nsIURI* GetBaseURI(bool aIsMainScript, WorkerPrivate* aWorkerPrivate) {
   MOZ_ASSERT(aWorkerPrivate);
   nsIURI* baseURI;
@@ -1964,24 +2038,25 @@ bool ScriptExecutorRunnable::WorkerRun(JSContext* aCx,
     MOZ_ASSERT(loadInfo.mMutedErrorFlag.isSome());
     options.setMutedErrors(loadInfo.mMutedErrorFlag.valueOr(true));
 
-    // Pass ownership of the data, first to local variables, then to the
-    // UniqueTwoByteChars moved into the |init| function.
+    // Pass ownership of the data, first to local variables, then to
+    // EvaluateWorkerScript.
     size_t dataLength = 0;
     char16_t* data = nullptr;
 
     std::swap(dataLength, loadInfo.mScriptTextLength);
     std::swap(data, loadInfo.mScriptTextBuf);
 
-    JS::SourceText<char16_t> srcBuf;
-    if (!srcBuf.init(aCx, JS::UniqueTwoByteChars(data), dataLength)) {
-      mScriptLoader.mRv.StealExceptionFromJSContext(aCx);
-      return true;
-    }
-
     // Our ErrorResult still shouldn't be a failure.
     MOZ_ASSERT(!mScriptLoader.mRv.Failed(), "Who failed it and why?");
-    JS::Rooted<JS::Value> unused(aCx);
-    if (!JS::Evaluate(aCx, options, srcBuf, &unused)) {
+    // The bytecode cache is shared by the whole process, so key it by the
+    // absolute URL. mURL is only rewritten to the final URL on the network
+    // path; scripts read from the ServiceWorker cache keep the string that
+    // was passed to importScripts(), which may be relative.
+    const nsString& cacheKey =
+        loadInfo.mFullURL.IsEmpty() ? loadInfo.mURL : loadInfo.mFullURL;
+    if (!EvaluateWorkerScript(aCx, cacheKey, options,
+                              aWorkerPrivate->IsServiceWorker(), data,
+                              dataLength)) {
       mScriptLoader.mRv.StealExceptionFromJSContext(aCx);
       return true;
     }
@@ -2149,6 +2224,8 @@ void LoadAllScripts(WorkerPrivate* aWorkerPrivate,
 
 namespace workerinternals {
 
+void ClearScriptBytecodeCache() { ScriptBytecodeCache::Clear(); }
+
 nsresult ChannelFromScriptURLMainThread(
     nsIPrincipal* aPrincipal, Document* aParentDoc, nsILoadGroup* aLoadGroup,
     nsIURI* aScriptURL, const Maybe<ClientInfo>& aClientInfo,
@@ -54,6 +54,9 @@ void Load(WorkerPrivate* aWorkerPrivate,
           const nsTArray<nsString>& aScriptURLs,
           WorkerScriptType aWorkerScriptType, ErrorResult& aRv);
 
+// Drops the bytecode shared between the workers of this process.
+void ClearScriptBytecodeCache();
+
 }  // namespace workerinternals
 
 }  // namespace dom
@@ -0,0 +1,179 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/workerinternals/ScriptBytecodeCache.h"
+#include "nsPrintfCString.h"
+
+using mozilla::dom::workerinternals::ScriptBytecodeCache;
+
+static void DigestOf(const char16_t* aSource,
+                     ScriptBytecodeCache::Digest& aDigest) {
+  ScriptBytecodeCache::ComputeDigest(aSource, NS_strlen(aSource), aDigest);
+}
+
+static JS::TranscodeBuffer MakeBytecode(size_t aLength, uint8_t aFill) {
+  JS::TranscodeBuffer bytecode;
+  MOZ_RELEASE_ASSERT(bytecode.appendN(aFill, aLength));
+  return bytecode;
+}
+
+static nsString URLFor(uint32_t aIndex) {
+  return NS_ConvertASCIItoUTF16(
+      nsPrintfCString("https://example.com/script%u.js", aIndex));
+}
+
+static bool IsCached(const nsAString& aURL) {
+  ScriptBytecodeCache::Digest digest;
+  DigestOf(u"source", digest);
+  JS::TranscodeBuffer bytecode;
+  return ScriptBytecodeCache::Lookup(aURL, digest, bytecode);
+}
+
+TEST(Workers_ScriptBytecodeCache, HitAndMiss)
+{
+  ScriptBytecodeCache::Clear();
+
+  ScriptBytecodeCache::Digest digest;
+  DigestOf(u"source", digest);
+  NS_NAMED_LITERAL_STRING(url, "https://example.com/worker.js");
+
+  JS::TranscodeBuffer bytecode;
+  ASSERT_FALSE(ScriptBytecodeCache::Lookup(url, digest, bytecode));
+
+  ScriptBytecodeCache::Store(url, digest, false, MakeBytecode(100, 7));
+  ASSERT_TRUE(ScriptBytecodeCache::Lookup(url, digest, bytecode));
+  ASSERT_EQ(bytecode.length(), 100u);
+  ASSERT_EQ(bytecode[0], 7);
+  ASSERT_EQ(bytecode[99], 7);
+
+  // Other URLs don't match, even with the same source.
+  ASSERT_FALSE(IsCached(NS_LITERAL_STRING("https://example.org/worker.js")));
+
+  ScriptBytecodeCache::Clear();
+  ASSERT_FALSE(IsCached(url));
+}
+
+TEST(Workers_ScriptBytecodeCache, DigestMismatch)
+{
+  ScriptBytecodeCache::Clear();
+
+  ScriptBytecodeCache::Digest oldDigest;
+  ScriptBytecodeCache::Digest newDigest;
+  DigestOf(u"old source", oldDigest);
+  DigestOf(u"new source", newDigest);
+  NS_NAMED_LITERAL_STRING(url, "https://example.com/worker.js");
+
+  ScriptBytecodeCache::Store(url, oldDigest, false, MakeBytecode(100, 1));
+
+  // The script changed on the server: the old bytecode must not be used.
+  JS::TranscodeBuffer bytecode;
+  ASSERT_FALSE(ScriptBytecodeCache::Lookup(url, newDigest, bytecode));
+  ASSERT_EQ(bytecode.length(), 0u);
+
+  // Storing the new bytecode replaces the stale entry.
+  ScriptBytecodeCache::Store(url, newDigest, false, MakeBytecode(50, 2));
+  ASSERT_EQ(ScriptBytecodeCache::Count(), 1u);
+  ASSERT_FALSE(ScriptBytecodeCache::Lookup(url, oldDigest, bytecode));
+  ASSERT_TRUE(ScriptBytecodeCache::Lookup(url, newDigest, bytecode));
+  ASSERT_EQ(bytecode.length(), 50u);
+  ASSERT_EQ(bytecode[0], 2);
+
+  ScriptBytecodeCache::Clear();
+}
+
+TEST(Workers_ScriptBytecodeCache, EvictsLeastRecentlyUsed)
+{
+  ScriptBytecodeCache::Clear();
+
+  ScriptBytecodeCache::Digest digest;
+  DigestOf(u"source", digest);
+
+  for (uint32_t i = 0; i < ScriptBytecodeCache::kMaxEntries; ++i) {
+    ScriptBytecodeCache::Store(URLFor(i), digest, false,
+                               MakeBytecode(10, uint8_t(i)));
+  }
+  ASSERT_EQ(ScriptBytecodeCache::Count(), ScriptBytecodeCache::kMaxEntries);
+
+  // Using the oldest entry makes the second one the least recently used.
+  ASSERT_TRUE(IsCached(URLFor(0)));
+
+  ScriptBytecodeCache::Store(URLFor(ScriptBytecodeCache::kMaxEntries), digest,
+                             false, MakeBytecode(10, 0));
+  ASSERT_EQ(ScriptBytecodeCache::Count(), ScriptBytecodeCache::kMaxEntries);
+  ASSERT_TRUE(IsCached(URLFor(0)));
+  ASSERT_FALSE(IsCached(URLFor(1)));
+  ASSERT_TRUE(IsCached(URLFor(2)));
+  ASSERT_TRUE(IsCached(URLFor(ScriptBytecodeCache::kMaxEntries)));
+
+  ScriptBytecodeCache::Clear();
+}
+
+TEST(Workers_ScriptBytecodeCache, EvictsBySize)
+{
+  ScriptBytecodeCache::Clear();
+
+  ScriptBytecodeCache::Digest digest;
+  DigestOf(u"source", digest);
+  const size_t half = ScriptBytecodeCache::kMaxSize / 2;
+
+  ScriptBytecodeCache::Store(URLFor(0), digest, false, MakeBytecode(half, 0));
+  ScriptBytecodeCache::Store(URLFor(1), digest, false, MakeBytecode(half, 1));
+  ASSERT_EQ(ScriptBytecodeCache::Count(), 2u);
+
+  ScriptBytecodeCache::Store(URLFor(2), digest, false, MakeBytecode(1, 2));
+  ASSERT_FALSE(IsCached(URLFor(0)));
+  ASSERT_TRUE(IsCached(URLFor(1)));
+  ASSERT_TRUE(IsCached(URLFor(2)));
+
+  // Bytecode larger than the whole cache is not stored, and doesn't flush
+  // what is there.
+  JS::TranscodeBuffer huge =
+      MakeBytecode(ScriptBytecodeCache::kMaxSize + 1, 3);
+  ScriptBytecodeCache::Store(URLFor(3), digest, false, std::move(huge));
+  ASSERT_FALSE(IsCached(URLFor(3)));
+  ASSERT_TRUE(IsCached(URLFor(1)));
+  ASSERT_TRUE(IsCached(URLFor(2)));
+
+  ScriptBytecodeCache::Clear();
+}
+
+TEST(Workers_ScriptBytecodeCache, PrefersServiceWorkerEntries)
+{
+  ScriptBytecodeCache::Clear();
+
+  ScriptBytecodeCache::Digest digest;
+  DigestOf(u"source", digest);
+  const uint32_t max = ScriptBytecodeCache::kMaxEntries;
+
+  // The ServiceWorker entry is the oldest, but regular entries go first.
+  ScriptBytecodeCache::Store(URLFor(0), digest, true, MakeBytecode(10, 0));
+  for (uint32_t i = 1; i <= max; ++i) {
+    ScriptBytecodeCache::Store(URLFor(i), digest, false,
+                               MakeBytecode(10, uint8_t(i)));
+  }
+  ASSERT_TRUE(IsCached(URLFor(0)));
+  ASSERT_FALSE(IsCached(URLFor(1)));
+  ASSERT_TRUE(IsCached(URLFor(max)));
+
+  ScriptBytecodeCache::Clear();
+
+  // A cache full of ServiceWorker entries doesn't take regular ones, but a
+  // new ServiceWorker entry evicts the oldest ServiceWorker one.
+  for (uint32_t i = 0; i < max; ++i) {
+    ScriptBytecodeCache::Store(URLFor(i), digest, true,
+                               MakeBytecode(10, uint8_t(i)));
+  }
+  ScriptBytecodeCache::Store(URLFor(max), digest, false, MakeBytecode(10, 0));
+  ASSERT_FALSE(IsCached(URLFor(max)));
+  ASSERT_TRUE(IsCached(URLFor(0)));
+
+  ScriptBytecodeCache::Store(URLFor(max + 1), digest, true,
+                             MakeBytecode(10, 0));
+  ASSERT_TRUE(IsCached(URLFor(max + 1)));
+  ASSERT_TRUE(IsCached(URLFor(0)));
+  ASSERT_FALSE(IsCached(URLFor(1)));
+
+  ScriptBytecodeCache::Clear();
+}
@@ -20,6 +20,7 @@
 #include "EditorEventListener.h"            // for EditorEventListener
 #include "HTMLEditRules.h"                  // for HTMLEditRules
 #include "InsertNodeTransaction.h"          // for InsertNodeTransaction
+#include "InsertNodesTransaction.h"         // for InsertNodesTransaction
 #include "InsertTextTransaction.h"          // for InsertTextTransaction
 #include "JoinNodeTransaction.h"            // for JoinNodeTransaction
 #include "PlaceholderTransaction.h"         // for PlaceholderTransaction
@@ -1431,6 +1432,44 @@ nsresult EditorBase::InsertNodeWithTransaction(
   return rv;
 }
 
+nsresult EditorBase::InsertNodesWithTransaction(
+    const nsTArray<OwningNonNull<nsIContent>>& aContents,
+    const EditorDOMPoint& aPointToInsert) {
+  MOZ_ASSERT(IsEditActionDataAvailable());
+
+  if (NS_WARN_IF(aContents.IsEmpty()) || NS_WARN_IF(!aPointToInsert.IsSet())) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  MOZ_ASSERT(aPointToInsert.IsSetAndValid());
+
+  AutoTopLevelEditSubActionNotifier maybeTopLevelEditSubAction(
+      *this, EditSubAction::eInsertNode, nsIEditor::eNext);
+
+  RefPtr<InsertNodesTransaction> transaction =
+      InsertNodesTransaction::Create(*this, aContents, aPointToInsert);
+  nsresult rv = DoTransactionInternal(transaction);
+
+  for (size_t i = 0; i < aContents.Length(); i++) {
+    RangeUpdaterRef().SelAdjInsertNode(aPointToInsert);
+  }
+
+  if (mRules && mRules->AsHTMLEditRules()) {
+    RefPtr<HTMLEditRules> htmlEditRules = mRules->AsHTMLEditRules();
+    htmlEditRules->DidInsertNodes(aContents[0], aContents.LastElement());
+  }
+
+  if (!mActionListeners.IsEmpty()) {
+    AutoActionListenerArray listeners(mActionListeners);
+    for (auto& listener : listeners) {
+      for (const OwningNonNull<nsIContent>& content : aContents) {
+        listener->DidInsertNode(content, rv);
+      }
+    }
+  }
+
+  return rv;
+}
+
 NS_IMETHODIMP
 EditorBase::SplitNode(nsINode* aNode, int32_t aOffset, nsINode** aNewLeftNode) {
   if (NS_WARN_IF(!aNode)) {
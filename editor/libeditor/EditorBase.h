@@ -74,6 +74,7 @@ class HTMLEditor;
 class HTMLEditUtils;
 class IMEContentObserver;
 class InsertNodeTransaction;
+class InsertNodesTransaction;
 class InsertTextTransaction;
 class JoinNodeTransaction;
 class PlaceholderTransaction;
@@ -955,6 +956,19 @@ class EditorBase : public nsIEditor,
   MOZ_CAN_RUN_SCRIPT nsresult InsertNodeWithTransaction(
       nsIContent& aContentToInsert, const EditorDOMPoint& aPointToInsert);
 
+  /**
+   * InsertNodesWithTransaction() inserts aContents, in order, before the
+   * child specified by aPointToInsert with a single transaction.  This is
+   * cheaper than calling InsertNodeWithTransaction() for each node when a
+   * lot of nodes go into the same container, e.g., when pasting.
+   *
+   * @param aContents           The nodes to be inserted.  Must not be empty.
+   * @param aPointToInsert      The insertion point of aContents.
+   */
+  MOZ_CAN_RUN_SCRIPT nsresult InsertNodesWithTransaction(
+      const nsTArray<OwningNonNull<nsIContent>>& aContents,
+      const EditorDOMPoint& aPointToInsert);
+
   /**
    * ReplaceContainerWithTransaction() creates new element whose name is
    * aTagName, moves all children in aOldContainer to the new element, then,
@@ -2312,6 +2326,7 @@ class EditorBase : public nsIEditor,
   friend class HTMLEditRules;
   friend class HTMLEditUtils;
   friend class InsertNodeTransaction;
+  friend class InsertNodesTransaction;
   friend class InsertTextTransaction;
   friend class JoinNodeTransaction;
   friend class SplitNodeTransaction;
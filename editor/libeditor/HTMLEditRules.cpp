@@ -10151,6 +10151,31 @@ void HTMLEditRules::DidInsertNode(nsIContent& aContent) {
   UpdateDocChangeRange(mUtilRange);
 }
 
+void HTMLEditRules::DidInsertNodes(nsIContent& aFirstNode,
+                                   nsIContent& aLastNode) {
+  if (!mListenerEnabled) {
+    return;
+  }
+
+  if (NS_WARN_IF(!CanHandleEditAction())) {
+    return;
+  }
+
+  AutoSafeEditorData setData(*this, *mHTMLEditor);
+
+  // The nodes are siblings, so one range covers all of them.
+  IgnoredErrorResult ignoredError;
+  mUtilRange->SelectNode(aFirstNode, ignoredError);
+  if (NS_WARN_IF(ignoredError.Failed())) {
+    return;
+  }
+  mUtilRange->SetEndAfter(aLastNode, ignoredError);
+  if (NS_WARN_IF(ignoredError.Failed())) {
+    return;
+  }
+  UpdateDocChangeRange(mUtilRange);
+}
+
 void HTMLEditRules::WillDeleteNode(nsINode& aChild) {
   if (!mListenerEnabled) {
     return;
@@ -126,6 +126,7 @@ class HTMLEditRules : public TextEditRules {
 
   void DidCreateNode(Element& aNewElement);
   void DidInsertNode(nsIContent& aNode);
+  void DidInsertNodes(nsIContent& aFirstNode, nsIContent& aLastNode);
   void WillDeleteNode(nsINode& aChild);
   void DidSplitNode(nsINode& aExistingRightNode, nsINode& aNewLeftNode);
   void WillJoinNodes(nsINode& aLeftNode, nsINode& aRightNode);
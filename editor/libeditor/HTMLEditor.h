@@ -2063,6 +2063,20 @@ class HTMLEditor final : public TextEditor,
                                 nsTArray<OwningNonNull<nsINode>>& outNodeList,
                                 nsINode* aStartContainer, int32_t aStartOffset,
                                 nsINode* aEndContainer, int32_t aEndOffset);
+
+  /**
+   * IsInsertableAsIsForPaste() returns true if DoInsertHTMLWithContext() may
+   * put aNode at aPointToInsert without splitting anything or merging it
+   * into the container, i.e., the node can be inserted in bulk with its
+   * siblings.
+   *
+   * @param aNode               A node in the list of nodes to paste.
+   * @param aPointToInsert      The current insertion point.
+   * @param aParentBlock        The block containing aPointToInsert.
+   */
+  bool IsInsertableAsIsForPaste(nsINode& aNode,
+                                const EditorDOMPoint& aPointToInsert,
+                                nsINode* aParentBlock) const;
   enum class StartOrEnd { start, end };
   void GetListAndTableParents(StartOrEnd aStartOrEnd,
                               nsTArray<OwningNonNull<nsINode>>& aNodeList,
@@ -79,6 +79,10 @@ using namespace dom;
 
 #define kInsertCookie "_moz_Insert Here_moz_"
 
+// Runs of pasted siblings at least this long are inserted with a single
+// InsertNodesTransaction.
+static const size_t kMinNodesToInsertAtOnce = 2;
+
 // some little helpers
 static bool FindIntegerAfterString(const char* aLeadingString, nsCString& aCStr,
                                    int32_t& foundNumber);
@@ -406,12 +410,44 @@ nsresult HTMLEditor::DoInsertHTMLWithContext(
             : GetBlockNodeParent(pointToInsert.GetContainer());
     nsCOMPtr<nsIContent> lastInsertNode;
     nsCOMPtr<nsINode> insertedContextParent;
-    for (OwningNonNull<nsINode>& curNode : nodeList) {
+    for (size_t i = 0; i < nodeList.Length(); i++) {
+      OwningNonNull<nsINode>& curNode = nodeList[i];
       if (NS_WARN_IF(curNode == fragmentAsNode) ||
           NS_WARN_IF(TextEditUtils::IsBody(curNode))) {
         return NS_ERROR_FAILURE;
       }
 
+      // Sibling nodes which the current container can take as they are,
+      // e.g., the rows of a big table or a lot of paragraphs, are inserted
+      // with one transaction rather than one transaction per node.
+      if (!insertedContextParent) {
+        nsTArray<OwningNonNull<nsIContent>> nodesToInsert;
+        for (size_t j = i; j < nodeList.Length(); j++) {
+          nsINode* node = nodeList[j];
+          if (!IsInsertableAsIsForPaste(*node, pointToInsert, parentBlock) ||
+              node->GetParentNode() != curNode->GetParentNode()) {
+            break;
+          }
+          nodesToInsert.AppendElement(*node->AsContent());
+        }
+        if (nodesToInsert.Length() >= kMinNodesToInsertAtOnce) {
+          {
+            AutoEditorDOMPointChildInvalidator lockOffset(pointToInsert);
+            rv = InsertNodesWithTransaction(nodesToInsert, pointToInsert);
+            if (NS_WARN_IF(NS_FAILED(rv))) {
+              return rv;
+            }
+          }
+          lastInsertNode = nodesToInsert.LastElement();
+          pointToInsert.Set(lastInsertNode);
+          DebugOnly<bool> advanced = pointToInsert.AdvanceOffset();
+          NS_WARNING_ASSERTION(advanced,
+                               "Failed to advance offset from inserted point");
+          i += nodesToInsert.Length() - 1;
+          continue;
+        }
+      }
+
       if (insertedContextParent) {
         // If we had to insert something higher up in the paste hierarchy,
         // we want to skip any further paste nodes that descend from that.
@@ -2454,6 +2490,32 @@ void HTMLEditor::CreateListOfNodesToPaste(
   iter.AppendList(functor, outNodeList);
 }
 
+bool HTMLEditor::IsInsertableAsIsForPaste(nsINode& aNode,
+                                          const EditorDOMPoint& aPointToInsert,
+                                          nsINode* aParentBlock) const {
+  if (!aNode.IsContent() || TextEditUtils::IsBody(&aNode)) {
+    return false;
+  }
+
+  // Table rows, lists and <pre>s may be merged into the container by
+  // DoInsertHTMLWithContext(), so they need to be handled one by one.
+  nsINode* container = aPointToInsert.GetContainer();
+  if (HTMLEditUtils::IsTableRow(&aNode) &&
+      HTMLEditUtils::IsTableRow(container)) {
+    return false;
+  }
+  if (HTMLEditUtils::IsList(&aNode) && (HTMLEditUtils::IsList(container) ||
+                                        HTMLEditUtils::IsListItem(container))) {
+    return false;
+  }
+  if (aParentBlock && HTMLEditUtils::IsPre(aParentBlock) &&
+      HTMLEditUtils::IsPre(&aNode)) {
+    return false;
+  }
+
+  return CanContain(*container, *aNode.AsContent());
+}
+
 void HTMLEditor::GetListAndTableParents(
     StartOrEnd aStartOrEnd, nsTArray<OwningNonNull<nsINode>>& aNodeList,
     nsTArray<OwningNonNull<Element>>& outArray) {
@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "InsertNodesTransaction.h"
+
+#include "mozilla/EditorBase.h"      // for EditorBase
+#include "mozilla/EditorDOMPoint.h"  // for EditorDOMPoint
+
+#include "mozilla/dom/Document.h"          // for Document
+#include "mozilla/dom/DocumentFragment.h"  // for DocumentFragment
+#include "mozilla/dom/Selection.h"         // for Selection
+
+#include "nsDebug.h"     // for NS_ENSURE_TRUE, etc.
+#include "nsError.h"     // for NS_ERROR_NULL_POINTER, etc.
+#include "nsIContent.h"  // for nsIContent
+
+namespace mozilla {
+
+using namespace dom;
+
+// static
+already_AddRefed<InsertNodesTransaction> InsertNodesTransaction::Create(
+    EditorBase& aEditorBase,
+    const nsTArray<OwningNonNull<nsIContent>>& aContents,
+    const EditorDOMPoint& aPointToInsert) {
+  RefPtr<InsertNodesTransaction> transaction =
+      new InsertNodesTransaction(aEditorBase, aContents, aPointToInsert);
+  return transaction.forget();
+}
+
+InsertNodesTransaction::InsertNodesTransaction(
+    EditorBase& aEditorBase,
+    const nsTArray<OwningNonNull<nsIContent>>& aContents,
+    const EditorDOMPoint& aPointToInsert)
+    : mContentsToInsert(aContents),
+      mPointToInsert(aPointToInsert),
+      mEditorBase(&aEditorBase) {
+  MOZ_ASSERT(!mContentsToInsert.IsEmpty());
+  MOZ_ASSERT(mPointToInsert.IsSetAndValid());
+  // Ensure mPointToInsert stores child at offset.
+  Unused << mPointToInsert.GetChild();
+}
+
+InsertNodesTransaction::~InsertNodesTransaction() {}
+
+NS_IMPL_CYCLE_COLLECTION_INHERITED(InsertNodesTransaction, EditTransactionBase,
+                                   mEditorBase, mContentsToInsert,
+                                   mPointToInsert)
+
+NS_IMPL_ADDREF_INHERITED(InsertNodesTransaction, EditTransactionBase)
+NS_IMPL_RELEASE_INHERITED(InsertNodesTransaction, EditTransactionBase)
+NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(InsertNodesTransaction)
+NS_INTERFACE_MAP_END_INHERITING(EditTransactionBase)
+
+NS_IMETHODIMP
+InsertNodesTransaction::DoTransaction() {
+  if (NS_WARN_IF(!mEditorBase) || NS_WARN_IF(mContentsToInsert.IsEmpty()) ||
+      NS_WARN_IF(!mPointToInsert.IsSet())) {
+    return NS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (!mPointToInsert.IsSetAndValid()) {
+    // It seems that DOM tree has been changed after first DoTransaction()
+    // and current RedoTranaction() call.
+    if (mPointToInsert.GetChild()) {
+      EditorDOMPoint newPointToInsert(mPointToInsert.GetChild());
+      if (!newPointToInsert.IsSet()) {
+        // The insertion point has been removed from the DOM tree.
+        // In this case, we should append the nodes to the container instead.
+        newPointToInsert.SetToEndOf(mPointToInsert.GetContainer());
+        if (NS_WARN_IF(!newPointToInsert.IsSet())) {
+          return NS_ERROR_FAILURE;
+        }
+      }
+      mPointToInsert = newPointToInsert;
+    } else {
+      mPointToInsert.SetToEndOf(mPointToInsert.GetContainer());
+      if (NS_WARN_IF(!mPointToInsert.IsSet())) {
+        return NS_ERROR_FAILURE;
+      }
+    }
+  }
+
+  // Collect the nodes in a fragment so that inserting them is a single
+  // DOM operation: one document update, and one ContentAppended
+  // notification when they go at the end of the container.
+  RefPtr<DocumentFragment> fragment =
+      mPointToInsert.GetContainer()->OwnerDoc()->CreateDocumentFragment();
+  ErrorResult error;
+  for (OwningNonNull<nsIContent>& content : mContentsToInsert) {
+    mEditorBase->MarkNodeDirty(content);
+    fragment->AppendChild(content, error);
+    if (NS_WARN_IF(error.Failed())) {
+      return error.StealNSResult();
+    }
+  }
+
+  mPointToInsert.GetContainer()->InsertBefore(*fragment,
+                                              mPointToInsert.GetChild(), error);
+  error.WouldReportJSException();
+  if (NS_WARN_IF(error.Failed())) {
+    return error.StealNSResult();
+  }
+
+  if (!mEditorBase->AllowsTransactionsToChangeSelection()) {
+    return NS_OK;
+  }
+
+  RefPtr<Selection> selection = mEditorBase->GetSelection();
+  if (NS_WARN_IF(!selection)) {
+    return NS_ERROR_FAILURE;
+  }
+
+  // Place the selection just after the last inserted node.
+  EditorRawDOMPoint afterInsertedNodes(mContentsToInsert.LastElement());
+  DebugOnly<bool> advanced = afterInsertedNodes.AdvanceOffset();
+  NS_WARNING_ASSERTION(advanced,
+                       "Failed to advance offset after the inserted nodes");
+  selection->Collapse(afterInsertedNodes, error);
+  if (NS_WARN_IF(error.Failed())) {
+    error.SuppressException();
+  }
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+InsertNodesTransaction::UndoTransaction() {
+  if (NS_WARN_IF(mContentsToInsert.IsEmpty()) ||
+      NS_WARN_IF(!mPointToInsert.IsSet())) {
+    return NS_ERROR_NOT_INITIALIZED;
+  }
+  // XXX If one of the inserted nodes has been moved to different container
+  //     node or just removed from the DOM tree, this fails at that node.
+  nsCOMPtr<nsINode> container = mPointToInsert.GetContainer();
+  ErrorResult error;
+  for (size_t i = mContentsToInsert.Length(); i > 0; i--) {
+    container->RemoveChild(mContentsToInsert[i - 1], error);
+    if (NS_WARN_IF(error.Failed())) {
+      return error.StealNSResult();
+    }
+  }
+  return NS_OK;
+}
+
+}  // namespace mozilla
@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef InsertNodesTransaction_h
+#define InsertNodesTransaction_h
+
+#include "mozilla/EditTransactionBase.h"  // for EditTransactionBase, etc.
+#include "mozilla/EditorDOMPoint.h"       // for EditorDOMPoint
+#include "mozilla/OwningNonNull.h"        // for OwningNonNull
+#include "nsCycleCollectionParticipant.h"
+#include "nsIContent.h"       // for nsIContent
+#include "nsISupportsImpl.h"  // for NS_DECL_ISUPPORTS_INHERITED
+#include "nsTArray.h"         // for nsTArray
+
+namespace mozilla {
+
+class EditorBase;
+
+/**
+ * A transaction that inserts a run of nodes at a single point.  The nodes
+ * are moved into a document fragment first, so the container sees one
+ * batched insertion instead of one per node.
+ */
+class InsertNodesTransaction final : public EditTransactionBase {
+ protected:
+  InsertNodesTransaction(EditorBase& aEditorBase,
+                         const nsTArray<OwningNonNull<nsIContent>>& aContents,
+                         const EditorDOMPoint& aPointToInsert);
+
+ public:
+  /**
+   * Create a transaction for inserting aContents, in order, before the
+   * child at aPointToInsert.
+   *
+   * @param aEditorBase         The editor which manages the transaction.
+   * @param aContents           The nodes to be inserted.  Must not be empty.
+   * @param aPointToInsert      The insertion point of aContents.
+   *                            If this refers end of the container, the
+   *                            transaction will append the nodes to the
+   *                            container.  Otherwise, will insert the nodes
+   *                            before child node referred by this.
+   * @return                    A InsertNodesTransaction which was initialized
+   *                            with the arguments.
+   */
+  static already_AddRefed<InsertNodesTransaction> Create(
+      EditorBase& aEditorBase,
+      const nsTArray<OwningNonNull<nsIContent>>& aContents,
+      const EditorDOMPoint& aPointToInsert);
+
+  NS_DECL_ISUPPORTS_INHERITED
+  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(InsertNodesTransaction,
+                                           EditTransactionBase)
+
+  NS_DECL_EDITTRANSACTIONBASE
+
+ protected:
+  virtual ~InsertNodesTransaction();
+
+  // The nodes to insert, in document order.
+  nsTArray<OwningNonNull<nsIContent>> mContentsToInsert;
+
+  // The DOM point we will insert mContentsToInsert.
+  EditorDOMPoint mPointToInsert;
+
+  // The editor for this transaction.
+  RefPtr<EditorBase> mEditorBase;
+};
+
+}  // namespace mozilla
+
+#endif  // #ifndef InsertNodesTransaction_h
@@ -37,18 +37,22 @@ mozilla::ipc::IPCResult RemoteSpellcheckEngineParent::RecvSetDictionaryFromList(
 
 mozilla::ipc::IPCResult RemoteSpellcheckEngineParent::RecvCheckAsync(
     nsTArray<nsString>&& aWords, CheckAsyncResolver&& aResolve) {
-  nsTArray<bool> misspells;
-  misspells.SetCapacity(aWords.Length());
-  for (auto& word : aWords) {
-    bool misspelled;
-    nsresult rv = mSpellChecker->CheckWord(word, &misspelled, nullptr);
-    // If CheckWord failed, we can't tell whether the word is correctly spelled
-    if (NS_FAILED(rv)) {
-      misspelled = false;
-    }
-    misspells.AppendElement(misspelled);
-  }
-  aResolve(std::move(misspells));
+  uint32_t count = aWords.Length();
+  mSpellChecker->CheckWords(aWords)->Then(
+      GetMainThreadSerialEventTarget(), __func__,
+      [aResolve](nsTArray<bool>&& aIsMisspelled) {
+        aResolve(std::move(aIsMisspelled));
+      },
+      [aResolve, count](nsresult aError) {
+        // If the check failed, we can't tell whether the words are correctly
+        // spelled
+        nsTArray<bool> misspells;
+        misspells.AppendElements(count);
+        for (auto& misspelled : misspells) {
+          misspelled = false;
+        }
+        aResolve(std::move(misspells));
+      });
   return IPC_OK();
 }
 
@@ -71,12 +71,53 @@
 #include "nsIPrefService.h"
 #include "nsIPrefBranch.h"
 #include "nsNetUtil.h"
+#include "nsNetCID.h"
 #include "mozilla/dom/ContentParent.h"
 #include "mozilla/Components.h"
+#include "mozilla/TaskQueue.h"
 
 using mozilla::dom::ContentParent;
 using namespace mozilla;
 
+// Upper bound on cached verdicts per dictionary. The cache is simply
+// dropped when it fills up; recent text refills it quickly.
+static const uint32_t kMaxCachedSpellResults = 8192;
+
+mozHunspellDictionary::mozHunspellDictionary(const char* aAffFile,
+                                             const char* aDicFile)
+    : mLock("mozHunspellDictionary::mLock"),
+      mHunspell(MakeUnique<Hunspell>(aAffFile, aDicFile)) {}
+
+mozHunspellDictionary::~mozHunspellDictionary() = default;
+
+const char* mozHunspellDictionary::GetDictEncoding() {
+  MutexAutoLock lock(mLock);
+  return mHunspell->get_dict_encoding();
+}
+
+bool mozHunspellDictionary::Spell(const std::string& aWord) {
+  nsDependentCSubstring key(aWord.data(), aWord.length());
+
+  MutexAutoLock lock(mLock);
+  bool correct;
+  if (mSpellCache.Get(key, &correct)) {
+    return correct;
+  }
+
+  correct = mHunspell->spell(aWord);
+  if (mSpellCache.Count() >= kMaxCachedSpellResults) {
+    mSpellCache.Clear();
+  }
+  mSpellCache.Put(key, correct);
+  return correct;
+}
+
+std::vector<std::string> mozHunspellDictionary::Suggest(
+    const std::string& aWord) {
+  MutexAutoLock lock(mLock);
+  return mHunspell->suggest(aWord);
+}
+
 NS_IMPL_CYCLE_COLLECTING_ADDREF(mozHunspell)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(mozHunspell)
 
@@ -85,6 +126,7 @@ NS_INTERFACE_MAP_BEGIN(mozHunspell)
   NS_INTERFACE_MAP_ENTRY(nsIObserver)
   NS_INTERFACE_MAP_ENTRY(nsISupportsWeakReference)
   NS_INTERFACE_MAP_ENTRY(nsIMemoryReporter)
+  NS_INTERFACE_MAP_ENTRY_CONCRETE(mozHunspell)
   NS_INTERFACE_MAP_ENTRY_AMBIGUOUS(nsISupports, mozISpellCheckingEngine)
   NS_INTERFACE_MAP_ENTRIES_CYCLE_COLLECTION(mozHunspell)
 NS_INTERFACE_MAP_END
@@ -103,7 +145,7 @@ template <>
 mozilla::CountingAllocatorBase<HunspellAllocator>::AmountType
     mozilla::CountingAllocatorBase<HunspellAllocator>::sAmount(0);
 
-mozHunspell::mozHunspell() : mHunspell(nullptr) {
+mozHunspell::mozHunspell() {
 #ifdef DEBUG
   // There must be only one instance of this class: it reports memory based on
   // a single static count in HunspellAllocator.
@@ -130,8 +172,11 @@ nsresult mozHunspell::Init() {
 mozHunspell::~mozHunspell() {
   mozilla::UnregisterWeakMemoryReporter(this);
 
+  if (mLookupQueue) {
+    mLookupQueue->BeginShutdown();
+  }
+
   mPersonalDictionary = nullptr;
-  delete mHunspell;
 }
 
 NS_IMETHODIMP
@@ -147,7 +192,6 @@ mozHunspell::GetDictionary(nsAString& aDictionary) {
 NS_IMETHODIMP
 mozHunspell::SetDictionary(const nsAString& aDictionary) {
   if (aDictionary.IsEmpty()) {
-    delete mHunspell;
     mHunspell = nullptr;
     mDictionary.Truncate();
     mAffixFileName.Truncate();
@@ -178,18 +222,16 @@ mozHunspell::SetDictionary(const nsAString& aDictionary) {
   dictFileName.SetLength(dotPos);
   dictFileName.AppendLiteral(".dic");
 
-  // SetDictionary can be called multiple times, so we might have a
-  // valid mHunspell instance which needs cleaned up.
-  delete mHunspell;
-
   mDictionary = aDictionary;
   mAffixFileName = affFileName;
 
-  mHunspell = new Hunspell(affFileName.get(), dictFileName.get());
-  if (!mHunspell) return NS_ERROR_OUT_OF_MEMORY;
+  // SetDictionary can be called multiple times; this drops our reference to
+  // any previous dictionary (and its cached verdicts). Lookups still pending
+  // on the background queue keep it alive until they finish.
+  mHunspell = new mozHunspellDictionary(affFileName.get(), dictFileName.get());
 
   auto encoding =
-      Encoding::ForLabelNoReplacement(mHunspell->get_dict_encoding());
+      Encoding::ForLabelNoReplacement(mHunspell->GetDictEncoding());
   if (!encoding) {
     return NS_ERROR_UCONV_NOCONV;
   }
@@ -424,7 +466,7 @@ mozHunspell::Check(const nsAString& aWord, bool* aResult) {
   nsresult rv = ConvertCharset(aWord, charsetWord);
   NS_ENSURE_SUCCESS(rv, rv);
 
-  *aResult = mHunspell->spell(charsetWord);
+  *aResult = mHunspell->Spell(charsetWord);
 
   if (!*aResult && mPersonalDictionary)
     rv = mPersonalDictionary->Check(aWord, aResult);
@@ -432,6 +474,76 @@ mozHunspell::Check(const nsAString& aWord, bool* aResult) {
   return rv;
 }
 
+RefPtr<CheckWordPromise> mozHunspell::CheckWordsAsync(
+    const nsTArray<nsString>& aWords) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!mHunspell) {
+    return CheckWordPromise::CreateAndReject(NS_ERROR_FAILURE, __func__);
+  }
+
+  // mEncoder is main thread only, so convert everything up front.
+  std::vector<std::string> charsetWords;
+  charsetWords.reserve(aWords.Length());
+  for (auto& word : aWords) {
+    std::string charsetWord;
+    nsresult rv = ConvertCharset(word, charsetWord);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return CheckWordPromise::CreateAndReject(rv, __func__);
+    }
+    charsetWords.push_back(std::move(charsetWord));
+  }
+
+  if (!mLookupQueue) {
+    nsCOMPtr<nsIEventTarget> target =
+        do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID);
+    if (NS_WARN_IF(!target)) {
+      return CheckWordPromise::CreateAndReject(NS_ERROR_NOT_AVAILABLE,
+                                               __func__);
+    }
+    mLookupQueue = new TaskQueue(target.forget());
+  }
+
+  RefPtr<mozHunspellDictionary> dictionary = mHunspell;
+  RefPtr<mozHunspell> self = this;
+  nsTArray<nsString> words(aWords);
+
+  return InvokeAsync(
+             mLookupQueue, __func__,
+             [dictionary, charsetWords = std::move(charsetWords)]() {
+               nsTArray<bool> misspells;
+               misspells.SetCapacity(charsetWords.size());
+               for (auto& charsetWord : charsetWords) {
+                 misspells.AppendElement(!dictionary->Spell(charsetWord));
+               }
+               return CheckWordPromise::CreateAndResolve(std::move(misspells),
+                                                         __func__);
+             })
+      ->Then(
+          GetMainThreadSerialEventTarget(), __func__,
+          [self, words = std::move(words)](nsTArray<bool>&& aMisspells) {
+            if (self->mPersonalDictionary) {
+              for (uint32_t i = 0; i < aMisspells.Length(); i++) {
+                if (!aMisspells[i]) {
+                  continue;
+                }
+                bool correct = false;
+                nsresult rv =
+                    self->mPersonalDictionary->Check(words[i], &correct);
+                if (NS_WARN_IF(NS_FAILED(rv))) {
+                  return CheckWordPromise::CreateAndReject(rv, __func__);
+                }
+                aMisspells[i] = !correct;
+              }
+            }
+            return CheckWordPromise::CreateAndResolve(std::move(aMisspells),
+                                                      __func__);
+          },
+          [](nsresult aError) {
+            return CheckWordPromise::CreateAndReject(aError, __func__);
+          });
+}
+
 NS_IMETHODIMP
 mozHunspell::Suggest(const nsAString& aWord, char16_t*** aSuggestions,
                      uint32_t* aSuggestionCount) {
@@ -450,7 +562,7 @@ mozHunspell::Suggest(const nsAString& aWord, char16_t*** aSuggestions,
   rv = ConvertCharset(aWord, charsetWord);
   NS_ENSURE_SUCCESS(rv, rv);
 
-  std::vector<std::string> suggestions = mHunspell->suggest(charsetWord);
+  std::vector<std::string> suggestions = mHunspell->Suggest(charsetWord);
   *aSuggestionCount = static_cast<uint32_t>(suggestions.size());
 
   if (*aSuggestionCount) {
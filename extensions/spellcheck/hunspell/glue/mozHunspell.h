@@ -61,6 +61,8 @@
 #define mozHunspell_h__
 
 #include <hunspell.hxx>
+#include <string>
+#include <vector>
 #include "mozISpellCheckingEngine.h"
 #include "mozIPersonalDictionary.h"
 #include "nsString.h"
@@ -70,6 +72,10 @@
 #include "nsIObserver.h"
 #include "nsIURI.h"
 #include "mozilla/Encoding.h"
+#include "mozilla/MozPromise.h"
+#include "mozilla/Mutex.h"
+#include "mozilla/UniquePtr.h"
+#include "nsDataHashtable.h"
 #include "nsInterfaceHashtable.h"
 #include "nsWeakReference.h"
 #include "nsCycleCollectionParticipant.h"
@@ -84,6 +90,44 @@
     }                                                \
   }
 
+#define MOZ_HUNSPELL_IID                             \
+  /* 3a6a1f4c-5d2e-4b8e-9f4f-0c6a8e7d2b91 */         \
+  {                                                  \
+    0x3a6a1f4c, 0x5d2e, 0x4b8e, {                    \
+      0x9f, 0x4f, 0x0c, 0x6a, 0x8e, 0x7d, 0x2b, 0x91 \
+    }                                                \
+  }
+
+namespace mozilla {
+class TaskQueue;
+typedef MozPromise<nsTArray<bool>, nsresult, false> CheckWordPromise;
+}  // namespace mozilla
+
+/**
+ * A loaded Hunspell dictionary and a cache of its recent verdicts. It is
+ * shared with the background lookup queue, so all use of the Hunspell
+ * instance is serialized by mLock. Words are in the dictionary's charset.
+ */
+class mozHunspellDictionary final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(mozHunspellDictionary)
+
+  mozHunspellDictionary(const char* aAffFile, const char* aDicFile);
+
+  const char* GetDictEncoding();
+
+  bool Spell(const std::string& aWord);
+
+  std::vector<std::string> Suggest(const std::string& aWord);
+
+ private:
+  ~mozHunspellDictionary();
+
+  mozilla::Mutex mLock;
+  mozilla::UniquePtr<Hunspell> mHunspell;
+  nsDataHashtable<nsCStringHashKey, bool> mSpellCache;
+};
+
 class mozHunspell final : public mozISpellCheckingEngine,
                           public nsIObserver,
                           public nsSupportsWeakReference,
@@ -93,6 +137,7 @@ class mozHunspell final : public mozISpellCheckingEngine,
   NS_DECL_MOZISPELLCHECKINGENGINE
   NS_DECL_NSIOBSERVER
   NS_DECL_CYCLE_COLLECTION_CLASS_AMBIGUOUS(mozHunspell, mozISpellCheckingEngine)
+  NS_DECLARE_STATIC_IID_ACCESSOR(MOZ_HUNSPELL_IID)
 
   mozHunspell();
 
@@ -103,6 +148,15 @@ class mozHunspell final : public mozISpellCheckingEngine,
   // helper method for converting a word to the charset of the dictionary
   nsresult ConvertCharset(const nsAString& aStr, std::string& aDst);
 
+  /**
+   * Checks aWords against the current dictionary. The words are converted
+   * here, the dictionary lookups run on a background task queue, and the
+   * personal dictionary is consulted back on the main thread for any word
+   * the dictionary rejected.
+   */
+  RefPtr<mozilla::CheckWordPromise> CheckWordsAsync(
+      const nsTArray<nsString>& aWords);
+
   NS_DECL_NSIMEMORYREPORTER
 
  protected:
@@ -123,7 +177,12 @@ class mozHunspell final : public mozISpellCheckingEngine,
   nsCOMArray<nsIFile> mDynamicDirectories;
   nsInterfaceHashtable<nsStringHashKey, nsIURI> mDynamicDictionaries;
 
-  Hunspell* mHunspell;
+  RefPtr<mozHunspellDictionary> mHunspell;
+
+  // Runs dictionary lookups for CheckWordsAsync. Created on first use.
+  RefPtr<mozilla::TaskQueue> mLookupQueue;
 };
 
+NS_DEFINE_STATIC_IID_ACCESSOR(mozHunspell, MOZ_HUNSPELL_IID)
+
 #endif
@@ -9,6 +9,7 @@
 #include "nsISupportsPrimitives.h"
 #include "nsISimpleEnumerator.h"
 #include "mozEnglishWordUtils.h"
+#include "mozHunspell.h"
 #include "mozilla/dom/ContentChild.h"
 #include "mozilla/PRemoteSpellcheckEngineChild.h"
 #include "mozilla/TextServicesDocument.h"
@@ -119,6 +120,12 @@ RefPtr<CheckWordPromise> mozSpellChecker::CheckWords(
     return mEngine->CheckWords(aWords);
   }
 
+  // Hunspell can look the words up off the main thread.
+  RefPtr<mozHunspell> hunspell = do_QueryObject(mSpellCheckingEngine);
+  if (hunspell) {
+    return hunspell->CheckWordsAsync(aWords);
+  }
+
   nsTArray<bool> misspells;
   misspells.SetCapacity(aWords.Length());
   for (auto& word : aWords) {
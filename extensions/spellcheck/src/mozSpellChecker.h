@@ -68,6 +68,8 @@ class mozSpellChecker final {
 
   /**
    * This is a flavor of CheckWord, is async version of CheckWord.
+   * In the chrome process the dictionary lookups run off the main thread
+   * when the engine is Hunspell.
    * @Param aWords is array of words to check
    */
   RefPtr<mozilla::CheckWordPromise> CheckWords(
@@ -0,0 +1,62 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/Omnijar.h"
+#include "nsIURI.h"
+#include "nsNetUtil.h"
+#include "nsZipArchive.h"
+
+#include "hnjalloc.h"
+
+using mozilla::Omnijar;
+
+// Dictionaries in the GRE omnijar should be read in place rather than through
+// a channel. Unpackaged builds have no omnijar, so there is nothing to check.
+TEST(Hyphenation, OmnijarDictionaryIsMapped)
+{
+  if (!Omnijar::IsInitialized()) {
+    return;
+  }
+  RefPtr<nsZipArchive> zip = Omnijar::GetReader(Omnijar::GRE);
+  if (!zip) {
+    return;
+  }
+
+  nsZipFind* find = nullptr;
+  zip->FindInit("hyphenation/hyph_*.dic", &find);
+  if (!find) {
+    return;
+  }
+  const char* result;
+  uint16_t len;
+  nsresult rv = find->FindNext(&result, &len);
+  nsAutoCString entry;
+  if (NS_SUCCEEDED(rv)) {
+    entry.Assign(result, len);
+  }
+  delete find;
+  if (entry.IsEmpty()) {
+    return;
+  }
+
+  // Build the spec the same way nsHyphenationManager and nsHyphenator do, so
+  // that it goes through URI normalization.
+  nsAutoCString spec;
+  ASSERT_TRUE(NS_SUCCEEDED(Omnijar::GetURIString(Omnijar::GRE, spec)));
+  spec.Append(entry);
+  nsCOMPtr<nsIURI> uri;
+  ASSERT_TRUE(NS_SUCCEEDED(NS_NewURI(getter_AddRefs(uri), spec)));
+  ASSERT_TRUE(NS_SUCCEEDED(uri->GetSpec(spec)));
+
+  hnjFile* f = hnjFopen(spec.get(), "r");
+  ASSERT_TRUE(f);
+  EXPECT_TRUE(hnjFisMapped(f));
+
+  // The first line of a libhyphen dictionary names its encoding.
+  char buf[64];
+  EXPECT_TRUE(hnjFgets(buf, sizeof(buf), f));
+  EXPECT_FALSE(hnjFeof(f));
+  hnjFclose(f);
+}
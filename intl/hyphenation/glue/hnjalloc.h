@@ -49,6 +49,9 @@ int hnjFeof(hnjFile* f);
 
 int hnjFgetc(hnjFile* f);
 
+/* Nonzero if f is read in place from an omnijar entry; for tests. */
+int hnjFisMapped(hnjFile* f);
+
 #ifdef __cplusplus
 }
 #endif
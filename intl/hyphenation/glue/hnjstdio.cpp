@@ -20,23 +20,75 @@
 #include "nsIInputStream.h"
 #include "nsIURI.h"
 #include "nsContentUtils.h"
+#include "nsZipArchive.h"
+#include "mozilla/Omnijar.h"
+#include "mozilla/UniquePtr.h"
 
 #define BUFSIZE 1024
 
 struct hnjFile_ {
+  // Exactly one of mStream and mItem is set. Dictionaries packaged in the
+  // omnijar are read in place through mItem (pointing straight into the
+  // mapped archive when the entry is stored uncompressed), so they don't go
+  // through a channel and a second copy in mBuffer.
   nsCOMPtr<nsIInputStream> mStream;
+  mozilla::UniquePtr<nsZipItemPtr<char>> mItem;
   char mBuffer[BUFSIZE];
+  const char* mData;
   uint32_t mCurPos;
   uint32_t mLimit;
   bool mEOF;
 };
 
+// If aURISpec refers to an entry in one of the omnijars, return a reader for
+// it that doesn't need a channel or an intermediate buffer.
+static mozilla::UniquePtr<nsZipItemPtr<char>> OpenOmnijarEntry(
+    const char* aURISpec) {
+  using mozilla::Omnijar;
+  if (!Omnijar::IsInitialized()) {
+    return nullptr;
+  }
+  nsDependentCString spec(aURISpec);
+  for (Omnijar::Type type : {Omnijar::GRE, Omnijar::APP}) {
+    nsAutoCString base;
+    if (NS_FAILED(Omnijar::GetURIString(type, base)) || base.IsEmpty() ||
+        !StringBeginsWith(spec, base)) {
+      continue;
+    }
+    RefPtr<nsZipArchive> zip = Omnijar::GetReader(type);
+    if (!zip) {
+      continue;
+    }
+    // Zip entry names have no leading slash, but the spec we were given may
+    // have one after the "!" if the base didn't end with a slash.
+    nsAutoCString entry(Substring(spec, base.Length()));
+    if (StringBeginsWith(entry, NS_LITERAL_CSTRING("/"))) {
+      entry.Cut(0, 1);
+    }
+    auto item = mozilla::MakeUnique<nsZipItemPtr<char>>(zip, entry.get());
+    if (item->Buffer()) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
 // replacement for fopen()
 // (not a full substitute: only supports read access)
 hnjFile* hnjFopen(const char* aURISpec, const char* aMode) {
   // this override only needs to support "r"
   NS_ASSERTION(!strcmp(aMode, "r"), "unsupported fopen() mode in hnjFopen");
 
+  if (auto item = OpenOmnijarEntry(aURISpec)) {
+    hnjFile* f = new hnjFile;
+    f->mData = item->Buffer();
+    f->mCurPos = 0;
+    f->mLimit = item->Length();
+    f->mEOF = false;
+    f->mItem = std::move(item);
+    return f;
+  }
+
   nsCOMPtr<nsIURI> uri;
   nsresult rv = NS_NewURI(getter_AddRefs(uri), aURISpec);
   if (NS_FAILED(rv)) {
@@ -60,6 +112,7 @@ hnjFile* hnjFopen(const char* aURISpec, const char* aMode) {
 
   hnjFile* f = new hnjFile;
   f->mStream = instream;
+  f->mData = f->mBuffer;
   f->mCurPos = 0;
   f->mLimit = 0;
   f->mEOF = false;
@@ -69,14 +122,16 @@ hnjFile* hnjFopen(const char* aURISpec, const char* aMode) {
 
 // replacement for fclose()
 int hnjFclose(hnjFile* f) {
-  NS_ASSERTION(f && f->mStream, "bad argument to hnjFclose");
+  NS_ASSERTION(f && (f->mStream || f->mItem), "bad argument to hnjFclose");
 
   int result = 0;
-  nsresult rv = f->mStream->Close();
-  if (NS_FAILED(rv)) {
-    result = EOF;
+  if (f->mStream) {
+    nsresult rv = f->mStream->Close();
+    if (NS_FAILED(rv)) {
+      result = EOF;
+    }
+    f->mStream = nullptr;
   }
-  f->mStream = nullptr;
 
   delete f;
   return result;
@@ -85,6 +140,11 @@ int hnjFclose(hnjFile* f) {
 // replacement for fgetc()
 int hnjFgetc(hnjFile* f) {
   if (f->mCurPos >= f->mLimit) {
+    if (!f->mStream) {
+      f->mEOF = true;
+      return EOF;
+    }
+
     f->mCurPos = 0;
 
     nsresult rv = f->mStream->Read(f->mBuffer, BUFSIZE, &f->mLimit);
@@ -98,7 +158,7 @@ int hnjFgetc(hnjFile* f) {
     }
   }
 
-  return f->mBuffer[f->mCurPos++];
+  return f->mData[f->mCurPos++];
 }
 
 // replacement for fgets()
@@ -130,3 +190,5 @@ char* hnjFgets(char* s, int n, hnjFile* f) {
 }
 
 int hnjFeof(hnjFile* f) { return f->mEOF ? EOF : 0; }
+
+int hnjFisMapped(hnjFile* f) { return f->mItem ? 1 : 0; }
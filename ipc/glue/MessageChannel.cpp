@@ -12,6 +12,7 @@
 #include "mozilla/Logging.h"
 #include "mozilla/Move.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/ProfilerCounts.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/Telemetry.h"
@@ -37,6 +38,8 @@ using namespace mozilla::tasktracer;
 static mozilla::LazyLogModule sLogModule("ipc");
 #define IPC_LOG(...) MOZ_LOG(sLogModule, LogLevel::Debug, (__VA_ARGS__))
 
+PROFILER_DEFINE_HOT_COUNT(IPCMessagesSent, "IPC", "Number of IPC messages sent")
+
 /*
  * IPC design:
  *
@@ -953,6 +956,7 @@ bool MessageChannel::Echo(Message* aMsg) {
 }
 
 bool MessageChannel::Send(Message* aMsg) {
+  AUTO_PROFILER_HOT_COUNT(IPCMessagesSent, 1);
   if (aMsg->size() >= kMinTelemetryMessageSize) {
     Telemetry::Accumulate(Telemetry::IPC_MESSAGE_SIZE2, aMsg->size());
   }
@@ -1399,6 +1403,7 @@ void MessageChannel::ProcessPendingRequests(
 }
 
 bool MessageChannel::Send(Message* aMsg, Message* aReply) {
+  AUTO_PROFILER_HOT_COUNT(IPCMessagesSent, 1);
   mozilla::TimeStamp start = TimeStamp::Now();
   if (aMsg->size() >= kMinTelemetryMessageSize) {
     Telemetry::Accumulate(Telemetry::IPC_MESSAGE_SIZE2, aMsg->size());
@@ -19,6 +19,7 @@
 #include "jstypes.h"
 #include "jsutil.h"
 
+#include "builtin/intl/Collator.h"
 #include "ds/Sort.h"
 #include "gc/Heap.h"
 #include "jit/InlinableNatives.h"
@@ -1884,6 +1885,29 @@ struct NumericElement {
   size_t elementIndex;
 };
 
+struct CollationKeyElement {
+  size_t keyBegin;
+  size_t keyEnd;
+  size_t elementIndex;
+};
+
+struct SortComparatorCollationKeys {
+  const CollationKeyBuffer& keys;
+
+  explicit SortComparatorCollationKeys(const CollationKeyBuffer& keys)
+      : keys(keys) {}
+
+  bool operator()(const CollationKeyElement& a, const CollationKeyElement& b,
+                  bool* lessOrEqualp) {
+    size_t lenA = a.keyEnd - a.keyBegin;
+    size_t lenB = b.keyEnd - b.keyBegin;
+    int result = memcmp(keys.begin() + a.keyBegin, keys.begin() + b.keyBegin,
+                        std::min(lenA, lenB));
+    *lessOrEqualp = result < 0 || (result == 0 && lenA <= lenB);
+    return true;
+  }
+};
+
 static bool ComparatorNumericLeftMinusRight(const NumericElement& a,
                                             const NumericElement& b,
                                             bool* lessOrEqualp) {
@@ -1990,6 +2014,34 @@ static ComparatorMatchResult MatchNumericComparator(JSContext* cx,
   return Match_None;
 }
 
+/*
+ * Recognize the function returned by the Intl.Collator.prototype.compare
+ * getter, i.e. the self-hosted collatorCompareToBind bound to a Collator.
+ */
+static CollatorObject* MatchCollatorComparator(JSContext* cx, JSObject* obj) {
+  if (!obj->is<JSFunction>()) {
+    return nullptr;
+  }
+
+  JSFunction* fun = &obj->as<JSFunction>();
+  if (!fun->isBoundFunction() || fun->getBoundFunctionArgumentCount() != 0) {
+    return nullptr;
+  }
+
+  JSObject* target = fun->getBoundFunctionTarget();
+  if (!target->is<JSFunction>() ||
+      !IsSelfHostedFunctionWithName(&target->as<JSFunction>(),
+                                    cx->names().collatorCompareToBind)) {
+    return nullptr;
+  }
+
+  const Value& thisv = fun->getBoundFunctionThis();
+  if (!thisv.isObject() || !thisv.toObject().is<CollatorObject>()) {
+    return nullptr;
+  }
+  return &thisv.toObject().as<CollatorObject>();
+}
+
 template <typename K, typename C>
 static inline bool MergeSortByKey(K keys, size_t len, K scratch, C comparator,
                                   MutableHandle<GCVector<Value>> vec) {
@@ -2111,6 +2163,47 @@ static bool SortNumerically(JSContext* cx, MutableHandle<GCVector<Value>> vec,
                         SortComparatorNumerics[comp], vec);
 }
 
+/*
+ * Sort strings as Intl.Collator.prototype.compare would.
+ *
+ * Rather than collating two strings on every comparison, compute the ICU sort
+ * key of each string once and sort the elements by these cached keys.
+ */
+static bool SortByCollationKeys(JSContext* cx,
+                                Handle<CollatorObject*> collator,
+                                MutableHandle<GCVector<Value>> vec,
+                                size_t len) {
+  MOZ_ASSERT(vec.length() >= len);
+
+  CollationKeyBuffer keys(cx);
+  Vector<CollationKeyElement, 0, TempAllocPolicy> keyElements(cx);
+
+  /* MergeSort uses the upper half as scratch space. */
+  if (!keyElements.resize(2 * len)) {
+    return false;
+  }
+
+  /* Compute the sort keys. */
+  RootedString str(cx);
+  for (size_t i = 0; i < len; i++) {
+    if (!CheckForInterrupt(cx)) {
+      return false;
+    }
+
+    str = vec[i].toString();
+    size_t keyBegin = keys.length();
+    if (!intl_AppendCollationKey(cx, collator, str, keys)) {
+      return false;
+    }
+
+    keyElements[i] = {keyBegin, keys.length(), i};
+  }
+
+  /* Sort Values in vec by their collation keys. */
+  return MergeSortByKey(keyElements.begin(), len, keyElements.begin() + len,
+                        SortComparatorCollationKeys(keys), vec);
+}
+
 static bool FillWithUndefined(JSContext* cx, HandleObject obj, uint32_t start,
                               uint32_t count) {
   MOZ_ASSERT(start < start + count,
@@ -2172,14 +2265,25 @@ bool js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp) {
   HandleValue fval = args[0];
   MOZ_ASSERT(fval.isUndefined() || IsCallable(fval));
 
+  RootedObject obj(cx, &args.thisv().toObject());
+
   ComparatorMatchResult comp;
+  Rooted<CollatorObject*> collator(cx);
   if (fval.isObject()) {
-    comp = MatchNumericComparator(cx, &fval.toObject());
+    // Sorting strings by a Collator's compare function can use precomputed
+    // collation keys. Only do this for packed arrays, where collecting the
+    // elements has no side-effects and we can still give up if we find an
+    // element that isn't a string.
+    if (IsPackedArray(obj)) {
+      collator = MatchCollatorComparator(cx, &fval.toObject());
+    }
+
+    comp = collator ? Match_None : MatchNumericComparator(cx, &fval.toObject());
     if (comp == Match_Failure) {
       return false;
     }
 
-    if (comp == Match_None) {
+    if (comp == Match_None && !collator) {
       // Non-optimized user supplied comparators perform much better when
       // called from within a self-hosted sorting function.
       args.rval().setBoolean(false);
@@ -2189,8 +2293,6 @@ bool js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp) {
     comp = Match_None;
   }
 
-  RootedObject obj(cx, &args.thisv().toObject());
-
   uint64_t length;
   if (!GetLengthProperty(cx, obj, &length)) {
     return false;
@@ -2295,7 +2397,19 @@ bool js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp) {
     }
 
     /* Here len == n + undefs + number_of_holes. */
-    if (comp == Match_None) {
+    if (collator) {
+      // An interrupt callback run while reading the elements may have made
+      // the array non-packed; if so, or if there are non-string elements,
+      // let the self-hosted code call the comparator, which converts the
+      // elements to strings.
+      if (!allStrings || !IsPackedArray(obj)) {
+        args.rval().setBoolean(false);
+        return true;
+      }
+      if (!SortByCollationKeys(cx, collator, &vec, n)) {
+        return false;
+      }
+    } else if (comp == Match_None) {
       /*
        * Sort using the default comparator converting all elements to
        * strings.
@@ -8,6 +8,8 @@
 
 #include "mozilla/Assertions.h"
 
+#include <algorithm>
+
 #include "jsapi.h"
 
 #include "builtin/intl/CommonFunctions.h"
@@ -473,6 +475,23 @@ static bool intl_CompareStrings(JSContext* cx, UCollator* coll,
   return true;
 }
 
+static UCollator* GetOrCreateUCollator(JSContext* cx,
+                                       Handle<CollatorObject*> collator) {
+  // Obtain a cached UCollator object.
+  void* priv =
+      collator->getReservedSlot(CollatorObject::UCOLLATOR_SLOT).toPrivate();
+  UCollator* coll = static_cast<UCollator*>(priv);
+  if (!coll) {
+    coll = NewUCollator(cx, collator);
+    if (!coll) {
+      return nullptr;
+    }
+    collator->setReservedSlot(CollatorObject::UCOLLATOR_SLOT,
+                              PrivateValue(coll));
+  }
+  return coll;
+}
+
 bool js::intl_CompareStrings(JSContext* cx, unsigned argc, Value* vp) {
   CallArgs args = CallArgsFromVp(argc, vp);
   MOZ_ASSERT(args.length() == 3);
@@ -483,17 +502,9 @@ bool js::intl_CompareStrings(JSContext* cx, unsigned argc, Value* vp) {
   Rooted<CollatorObject*> collator(cx,
                                    &args[0].toObject().as<CollatorObject>());
 
-  // Obtain a cached UCollator object.
-  void* priv =
-      collator->getReservedSlot(CollatorObject::UCOLLATOR_SLOT).toPrivate();
-  UCollator* coll = static_cast<UCollator*>(priv);
+  UCollator* coll = GetOrCreateUCollator(cx, collator);
   if (!coll) {
-    coll = NewUCollator(cx, collator);
-    if (!coll) {
-      return false;
-    }
-    collator->setReservedSlot(CollatorObject::UCOLLATOR_SLOT,
-                              PrivateValue(coll));
+    return false;
   }
 
   // Use the UCollator to actually compare the strings.
@@ -502,6 +513,53 @@ bool js::intl_CompareStrings(JSContext* cx, unsigned argc, Value* vp) {
   return intl_CompareStrings(cx, coll, str1, str2, args.rval());
 }
 
+bool js::intl_AppendCollationKey(JSContext* cx,
+                                 Handle<CollatorObject*> collator,
+                                 HandleString str, CollationKeyBuffer& keys) {
+  UCollator* coll = GetOrCreateUCollator(cx, collator);
+  if (!coll) {
+    return false;
+  }
+
+  AutoStableStringChars stableChars(cx);
+  if (!stableChars.initTwoByte(cx, str)) {
+    return false;
+  }
+  mozilla::Range<const char16_t> chars = stableChars.twoByteRange();
+
+  // Sort keys are usually a little longer than the string itself; start with
+  // a guess and retry once with the exact size ICU reports.
+  size_t begin = keys.length();
+  size_t capacity =
+      std::min<size_t>(std::max<size_t>(chars.length() * 2 + 16, 32), INT32_MAX);
+  if (!keys.growBy(capacity)) {
+    return false;
+  }
+
+  int32_t needed =
+      ucol_getSortKey(coll, chars.begin().get(), chars.length(),
+                      keys.begin() + begin, int32_t(capacity));
+  if (needed <= 0) {
+    ReportInternalError(cx);
+    return false;
+  }
+  if (size_t(needed) > capacity) {
+    if (!keys.growBy(size_t(needed) - capacity)) {
+      return false;
+    }
+    needed = ucol_getSortKey(coll, chars.begin().get(), chars.length(),
+                             keys.begin() + begin, needed);
+    if (needed <= 0 || begin + size_t(needed) > keys.length()) {
+      ReportInternalError(cx);
+      return false;
+    }
+  }
+
+  // Drop the terminating zero byte. Sort keys contain no other zero bytes.
+  keys.shrinkTo(begin + size_t(needed) - 1);
+  return true;
+}
+
 bool js::intl_isUpperCaseFirst(JSContext* cx, unsigned argc, Value* vp) {
   CallArgs args = CallArgsFromVp(argc, vp);
   MOZ_ASSERT(args.length() == 1);
@@ -10,7 +10,9 @@
 #include <stdint.h>
 
 #include "builtin/SelfHostingDefines.h"
+#include "js/AllocPolicy.h"
 #include "js/Class.h"
+#include "js/Vector.h"
 #include "vm/NativeObject.h"
 
 namespace js {
@@ -97,6 +99,19 @@ extern MOZ_MUST_USE bool intl_CompareStrings(JSContext* cx, unsigned argc,
 extern MOZ_MUST_USE bool intl_isUpperCaseFirst(JSContext* cx, unsigned argc,
                                                JS::Value* vp);
 
+using CollationKeyBuffer = Vector<uint8_t, 0, TempAllocPolicy>;
+
+/**
+ * Appends the ICU sort key of |str| under the locale and collation options of
+ * the given Collator to |keys|, without a terminating zero byte. Comparing two
+ * sort keys bytewise (the shorter key first on a common prefix) orders them
+ * exactly as intl_CompareStrings orders the strings, so a sort can compute
+ * each key once instead of collating the strings on every comparison.
+ */
+extern MOZ_MUST_USE bool intl_AppendCollationKey(
+    JSContext* cx, JS::Handle<CollatorObject*> collator, JS::HandleString str,
+    CollationKeyBuffer& keys);
+
 }  // namespace js
 
 #endif /* builtin_intl_Collator_h */
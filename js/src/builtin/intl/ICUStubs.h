@@ -144,6 +144,12 @@ inline UCollationResult ucol_strcoll(const UCollator* coll, const UChar* source,
   MOZ_CRASH("ucol_strcoll: Intl API disabled");
 }
 
+inline int32_t ucol_getSortKey(const UCollator* coll, const UChar* source,
+                               int32_t sourceLength, uint8_t* result,
+                               int32_t resultLength) {
+  MOZ_CRASH("ucol_getSortKey: Intl API disabled");
+}
+
 inline void ucol_close(UCollator* coll) {
   MOZ_CRASH("ucol_close: Intl API disabled");
 }
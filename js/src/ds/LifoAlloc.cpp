@@ -399,6 +399,42 @@ void LifoAlloc::transferUnusedFrom(LifoAlloc* other) {
   other->decrementCurSize(size);
 }
 
+void LifoAlloc::transferUnusedFrom(LifoAlloc* other, size_t retainSize) {
+  MOZ_ASSERT(!markCount);
+
+  detail::BumpChunk* lastRetained = nullptr;
+  size_t retained = 0;
+  for (detail::BumpChunk& bc : other->unused_) {
+    size_t chunkSize = bc.computedSizeOfIncludingThis();
+    if (retained + chunkSize > retainSize) {
+      break;
+    }
+    retained += chunkSize;
+    lastRetained = &bc;
+  }
+
+  if (!lastRetained) {
+    transferUnusedFrom(other);
+    return;
+  }
+
+  BumpChunkList transferred = other->unused_.splitAfter(lastRetained);
+
+  size_t size = 0;
+  for (detail::BumpChunk& bc : transferred) {
+    size += bc.computedSizeOfIncludingThis();
+  }
+
+  appendUnused(std::move(transferred));
+  incrementCurSize(size);
+  other->decrementCurSize(size);
+}
+
+void LifoAlloc::freeUnusedChunks(size_t retainSize) {
+  LifoAlloc toFree(defaultChunkSize_);
+  toFree.transferUnusedFrom(this, retainSize);
+}
+
 #ifdef LIFO_CHUNK_PROTECT
 void LifoAlloc::setReadOnly() {
   for (detail::BumpChunk& bc : chunks_) {
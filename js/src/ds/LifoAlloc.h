@@ -630,6 +630,14 @@ class LifoAlloc {
   // Append unused chunks from |other|. They are removed from |other|.
   void transferUnusedFrom(LifoAlloc* other);
 
+  // As above, but the leading unused chunks of |other| whose total size fits
+  // in |retainSize| are left in |other|, to be reused by its next allocations.
+  void transferUnusedFrom(LifoAlloc* other, size_t retainSize);
+
+  // Free the unused chunks, except for the leading ones whose total size fits
+  // in |retainSize|.
+  void freeUnusedChunks(size_t retainSize);
+
   ~LifoAlloc() { freeAll(); }
 
   size_t defaultChunkSize() const { return defaultChunkSize_; }
@@ -3696,10 +3696,11 @@ void GCRuntime::waitBackgroundSweepEnd() {
   }
 }
 
-void GCRuntime::queueUnusedLifoBlocksForFree(LifoAlloc* lifo) {
+void GCRuntime::queueUnusedLifoBlocksForFree(LifoAlloc* lifo,
+                                             size_t retainSize) {
   MOZ_ASSERT(JS::RuntimeHeapIsBusy());
   AutoLockHelperThreadState lock;
-  lifoBlocksToFree.ref().transferUnusedFrom(lifo);
+  lifoBlocksToFree.ref().transferUnusedFrom(lifo, retainSize);
 }
 
 void GCRuntime::queueAllLifoBlocksForFree(LifoAlloc* lifo) {
@@ -4030,8 +4031,14 @@ void GCRuntime::purgeRuntime() {
     zone->functionToStringCache().purge();
   }
 
+  // Keep some of the compilation arena for the next compilations, unless we
+  // are trying to release as much memory as possible.
+  bool shrinking = invocationKind == GC_SHRINK;
+  size_t retainSize =
+      shrinking ? 0 : JSContext::TEMP_LIFO_ALLOC_RETAINED_SIZE;
+
   JSContext* cx = rt->mainContextFromOwnThread();
-  queueUnusedLifoBlocksForFree(&cx->tempLifoAlloc());
+  queueUnusedLifoBlocksForFree(&cx->tempLifoAlloc(), retainSize);
   cx->interpreterStack().purge(rt);
   cx->frontendCollectionPool().purge();
 
@@ -4047,7 +4054,7 @@ void GCRuntime::purgeRuntime() {
   // If we're the main runtime, tell helper threads to free their unused
   // memory when they are next idle.
   if (!rt->parentRuntime) {
-    HelperThreadState().triggerFreeUnusedMemory();
+    HelperThreadState().triggerFreeUnusedMemory(shrinking);
   }
 }
 
@@ -467,7 +467,7 @@ class GCRuntime {
 #endif
 
   // Queue memory memory to be freed on a background thread if possible.
-  void queueUnusedLifoBlocksForFree(LifoAlloc* lifo);
+  void queueUnusedLifoBlocksForFree(LifoAlloc* lifo, size_t retainSize = 0);
   void queueAllLifoBlocksForFree(LifoAlloc* lifo);
   void queueAllLifoBlocksForFreeAfterMinorGC(LifoAlloc* lifo);
   void queueBuffersForFreeAfterMinorGC(Nursery::BufferSet& buffers);
@@ -27,6 +27,8 @@
 
 #include "irregexp/RegExpAST.h"
 
+#include "util/Unicode.h"
+
 using namespace js;
 using namespace js::irregexp;
 
@@ -260,3 +262,69 @@ RegExpLookahead::IsAnchoredAtStart()
 {
     return is_positive() && body()->IsAnchoredAtStart();
 }
+
+// ----------------------------------------------------------------------------
+// Literal prefix extraction
+
+static bool
+AppendLiteralChars(const CharacterVector& chars, bool unicode, CharacterVector* prefix)
+{
+    for (size_t i = 0; i < chars.length(); i++) {
+        if (prefix->length() >= kMaxLiteralPrefixLength)
+            return false;
+        if (unicode && unicode::IsSurrogate(chars[i]))
+            return false;
+        prefix->append(chars[i]);
+    }
+    return true;
+}
+
+// Returns true if |tree| always matches exactly the code units appended to
+// |prefix|, so the caller may continue with whatever follows |tree|.
+static bool
+AppendLiteralPrefix(RegExpTree* tree, bool unicode, CharacterVector* prefix)
+{
+    if (RegExpAtom* atom = tree->AsAtom())
+        return AppendLiteralChars(atom->data(), unicode, prefix);
+
+    if (RegExpText* text = tree->AsText()) {
+        const TextElementVector& elements = text->elements();
+        for (size_t i = 0; i < elements.length(); i++) {
+            const TextElement& elm = elements[i];
+            if (elm.text_type() != TextElement::ATOM)
+                return false;
+            if (!AppendLiteralChars(elm.atom()->data(), unicode, prefix))
+                return false;
+        }
+        return true;
+    }
+
+    if (RegExpAlternative* alternative = tree->AsAlternative()) {
+        const RegExpTreeVector& nodes = alternative->nodes();
+        for (size_t i = 0; i < nodes.length(); i++) {
+            if (!AppendLiteralPrefix(nodes[i], unicode, prefix))
+                return false;
+        }
+        return true;
+    }
+
+    if (RegExpCapture* capture = tree->AsCapture())
+        return AppendLiteralPrefix(capture->body(), unicode, prefix);
+
+    // The first iteration of a quantifier with a non-zero minimum is
+    // required, but we can't know what follows it.
+    if (RegExpQuantifier* quantifier = tree->AsQuantifier()) {
+        if (quantifier->min() > 0)
+            AppendLiteralPrefix(quantifier->body(), unicode, prefix);
+        return false;
+    }
+
+    return false;
+}
+
+void
+irregexp::ExtractLiteralPrefix(RegExpTree* tree, bool unicode, CharacterVector* prefix)
+{
+    MOZ_ASSERT(prefix->length() == 0);
+    AppendLiteralPrefix(tree, unicode, prefix);
+}
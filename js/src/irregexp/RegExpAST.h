@@ -441,6 +441,18 @@ class RegExpEmpty : public RegExpTree
     }
 };
 
+// Literal prefixes longer than this are truncated; the matcher verifies the
+// rest of the pattern anyway, so a longer prefix only makes the scan slower.
+static const size_t kMaxLiteralPrefixLength = 32;
+
+// Append to |prefix| the code units that every match of |tree| must start
+// with. The prefix is used to skip ahead to candidate positions before
+// entering the compiled matcher. In unicode mode the prefix stops before the
+// first surrogate code unit, since a lone surrogate in the pattern must not
+// match half of a surrogate pair in the input.
+void
+ExtractLiteralPrefix(RegExpTree* tree, bool unicode, CharacterVector* prefix);
+
 } } // namespace js::irregexp
 
 #endif  // V8_REGEXP_AST_H_
@@ -0,0 +1,45 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+
+BEGIN_TEST(testIntlCollatorSort) {
+  // This test should only attempt to run if we have Intl support.
+  JS::Rooted<JS::Value> haveIntl(cx);
+  EVAL("typeof Intl !== 'undefined'", &haveIntl);
+  if (!haveIntl.toBoolean()) {
+    return true;
+  }
+
+  // Sorting with a Collator's compare function uses precomputed collation
+  // keys; the result must match sorting with a plain comparator calling it.
+  EXEC(
+      "var words = ['zebra', '\\u00c4pfel', 'apple', 'r\\u00e9sum\\u00e9', 'resume', 'Zoo', \n"
+      "             'a', '', 'A', '\\u00e4', '\\u00e4b', 'ab', 'Ab', 'b', '\\u00e9', \n"
+      "             'e\\u0301', 'ZEBRA', 'zebra'];\n"
+      "for (var i = 0; i < 200; i++) words.push('w' + ((i * 7919) % 211));\n"
+      "var options = [{}, {sensitivity: 'base'}, {numeric: true},\n"
+      "               {caseFirst: 'upper'}];\n"
+      "for (var locale of ['en', 'de', 'sv']) {\n"
+      "  for (var opts of options) {\n"
+      "    var collator = new Intl.Collator(locale, opts);\n"
+      "    var compare = collator.compare;\n"
+      "    var expected = words.slice().sort((x, y) => compare(x, y));\n"
+      "    var actual = words.slice().sort(compare);\n"
+      "    if (expected.join() !== actual.join())\n"
+      "      throw 'mismatch for ' + locale + ' ' + JSON.stringify(opts) +\n"
+      "            ': ' + actual.join();\n"
+      "  }\n"
+      "}");
+
+  // Arrays with non-string elements fall back to calling the comparator.
+  EXEC(
+      "var mixed = [3, 'b', undefined, 1, 'a', 20];\n"
+      "mixed.sort(new Intl.Collator('en').compare);\n"
+      "if (mixed.join() !== '1,20,3,a,b,')\n"
+      "  throw 'bad mixed sort: ' + mixed.join();");
+
+  return true;
+}
+END_TEST(testIntlCollatorSort)
@@ -0,0 +1,40 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ds/LifoAlloc.h"
+#include "jsapi-tests/tests.h"
+
+BEGIN_TEST(testLifoAllocRetainUnusedChunks) {
+  const size_t chunkSize = 4 * 1024;
+  const size_t retainSize = 16 * 1024;
+
+  js::LifoAlloc lifo(chunkSize);
+  for (size_t i = 0; i < 64; i++) {
+    CHECK(lifo.alloc(1024));
+  }
+  lifo.releaseAll();
+
+  size_t totalSize = lifo.computedSizeOfExcludingThis();
+  CHECK(totalSize > retainSize);
+
+  // Only the chunks which don't fit in |retainSize| are transferred.
+  js::LifoAlloc toFree(chunkSize);
+  toFree.transferUnusedFrom(&lifo, retainSize);
+
+  size_t retainedSize = lifo.computedSizeOfExcludingThis();
+  CHECK(retainedSize > 0);
+  CHECK(retainedSize <= retainSize);
+  CHECK_EQUAL(retainedSize + toFree.computedSizeOfExcludingThis(), totalSize);
+
+  // The retained chunks are reused by the next allocations.
+  CHECK(lifo.alloc(1024));
+  CHECK_EQUAL(lifo.computedSizeOfExcludingThis(), retainedSize);
+  lifo.releaseAll();
+
+  lifo.freeUnusedChunks(0);
+  CHECK_EQUAL(lifo.computedSizeOfExcludingThis(), size_t(0));
+
+  return true;
+}
+END_TEST(testLifoAllocRetainUnusedChunks)
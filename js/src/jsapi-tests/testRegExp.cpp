@@ -62,3 +62,47 @@ BEGIN_TEST(testGetRegExpSource) {
   return true;
 }
 END_TEST(testGetRegExpSource)
+
+BEGIN_TEST(testRegExpLiteralPrefix) {
+  JS::RootedValue val(cx);
+
+  // Patterns with a required literal prefix skip ahead to candidate
+  // positions; make sure matching semantics are unchanged.
+  EVAL("/ERROR: (\\d+)/.exec('INFO: 1\\nWARN: 2\\nERROR: 37\\n')[1]", &val);
+  CHECK(val.isString());
+  CHECK(JS_FlatStringEqualsAscii(JS_ASSERT_STRING_IS_FLAT(val.toString()),
+                                 "37"));
+
+  EVAL("/ab+c/.exec('aaabbbc').index", &val);
+  CHECK_SAME(val, JS::Int32Value(2));
+
+  EVAL("/key=\\w+/.exec('key=')", &val);
+  CHECK(val.isNull());
+
+  EVAL("/x\\by/.test('x y xy')", &val);
+  CHECK_SAME(val, JS::FalseValue());
+
+  EVAL("/\\bfoo/.exec('afoo foo').index", &val);
+  CHECK_SAME(val, JS::Int32Value(5));
+
+  EVAL("var re = /id(\\d)/g; re.lastIndex = 3; re.exec('id1 id2 id3')[1]",
+       &val);
+  CHECK(JS_FlatStringEqualsAscii(JS_ASSERT_STRING_IS_FLAT(val.toString()),
+                                 "2"));
+
+  EVAL("/\\uDC00x/u.test('\\uD800\\uDC00x')", &val);
+  CHECK_SAME(val, JS::FalseValue());
+
+  // A match-only compile drops the leading .*, which must not leak into the
+  // start position used by a later exec() or match() on the same regexp.
+  EVAL("var re2 = /.*foo\\d/; re2.test('abcfoo1'); re2.exec('abcfoo1')[0]",
+       &val);
+  CHECK(JS_FlatStringEqualsAscii(JS_ASSERT_STRING_IS_FLAT(val.toString()),
+                                 "abcfoo1"));
+
+  EVAL("var re3 = /.*bar/; re3.test('xbar'); 'xxbar'.match(re3).index", &val);
+  CHECK_SAME(val, JS::Int32Value(0));
+
+  return true;
+}
+END_TEST(testRegExpLiteralPrefix)
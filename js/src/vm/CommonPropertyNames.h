@@ -72,6 +72,7 @@
   MACRO(catch, catch_, "catch")                                                \
   MACRO(class, class_, "class")                                                \
   MACRO(Collator, Collator, "Collator")                                        \
+  MACRO(collatorCompareToBind, collatorCompareToBind, "collatorCompareToBind") \
   MACRO(collections, collections, "collections")                               \
   MACRO(columnNumber, columnNumber, "columnNumber")                            \
   MACRO(comma, comma, ",")                                                     \
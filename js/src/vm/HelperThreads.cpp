@@ -1222,7 +1222,7 @@ bool GlobalHelperThreadState::checkTaskThreadLimit(size_t maxThreads,
   return true;
 }
 
-void GlobalHelperThreadState::triggerFreeUnusedMemory() {
+void GlobalHelperThreadState::triggerFreeUnusedMemory(bool shrinking) {
   if (!CanUseExtraThreads()) {
     return;
   }
@@ -1230,6 +1230,7 @@ void GlobalHelperThreadState::triggerFreeUnusedMemory() {
   AutoLockHelperThreadState lock;
   for (auto& thread : *threads) {
     thread.shouldFreeUnusedMemory = true;
+    thread.shouldFreeAllUnusedMemory |= shrinking;
   }
   notifyAll(PRODUCER, lock);
 }
@@ -2482,7 +2483,13 @@ void HelperThread::maybeFreeUnusedMemory(JSContext* cx) {
   cx->tempLifoAlloc().releaseAll();
 
   if (shouldFreeUnusedMemory) {
-    cx->tempLifoAlloc().freeAll();
+    if (shouldFreeAllUnusedMemory) {
+      cx->tempLifoAlloc().freeAll();
+    } else {
+      cx->tempLifoAlloc().freeUnusedChunks(
+          JSContext::TEMP_LIFO_ALLOC_RETAINED_SIZE);
+    }
     shouldFreeUnusedMemory = false;
+    shouldFreeAllUnusedMemory = false;
   }
 }
@@ -327,7 +327,7 @@ class GlobalHelperThreadState {
   template <typename T>
   bool checkTaskThreadLimit(size_t maxThreads, bool isMaster = false) const;
 
-  void triggerFreeUnusedMemory();
+  void triggerFreeUnusedMemory(bool shrinking);
 
  private:
   /*
@@ -380,6 +380,12 @@ struct HelperThread {
    */
   bool shouldFreeUnusedMemory;
 
+  /*
+   * Whether the next free of unused memory should also release the chunks
+   * normally retained for the next compilations.
+   */
+  bool shouldFreeAllUnusedMemory;
+
   /* The current task being executed by this thread, if any. */
   mozilla::Maybe<HelperTaskUnion> currentTask;
 
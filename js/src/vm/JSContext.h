@@ -647,6 +647,13 @@ struct JSContext : public JS::RootingContext,
   /* Temporary arena pool used while compiling and decompiling. */
   static const size_t TEMP_LIFO_ALLOC_PRIMARY_CHUNK_SIZE = 4 * 1024;
 
+  /*
+   * Amount of unused chunks of the temporary arena pool which survive a
+   * non-shrinking GC, so that the following compilations don't have to
+   * allocate and fault in fresh chunks.
+   */
+  static const size_t TEMP_LIFO_ALLOC_RETAINED_SIZE = 256 * 1024;
+
  private:
   js::ThreadData<js::LifoAlloc> tempLifoAlloc_;
 
@@ -910,6 +910,7 @@ void RegExpShared::traceChildren(JSTracer* trc) {
   }
 
   TraceNullableEdge(trc, &source, "RegExpShared source");
+  TraceNullableEdge(trc, &literalPrefix, "RegExpShared literalPrefix");
   for (auto& comp : compilationArray) {
     TraceNullableEdge(trc, &comp.jitCode, "RegExpShared code");
   }
@@ -964,6 +965,22 @@ bool RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re,
 
   re->parenCount = data.capture_count;
 
+  // Sticky regexps only ever match at the start index, so scanning ahead for
+  // the literal prefix can't help them. The match-only parse drops a leading
+  // .* from the tree, so only a normal parse tells us where matches start.
+  if (mode == Normal && !re->literalPrefix && !re->ignoreCase() &&
+      !re->sticky() && !re->canStringMatch &&
+      !data.tree->IsAnchoredAtStart()) {
+    irregexp::CharacterVector prefix(allocScope.alloc());
+    irregexp::ExtractLiteralPrefix(data.tree, re->unicode(), &prefix);
+    if (prefix.length() > 0) {
+      re->literalPrefix = AtomizeChars(cx, prefix.begin(), prefix.length());
+      if (!re->literalPrefix) {
+        return false;
+      }
+    }
+  }
+
   JitCodeTables tables;
   irregexp::RegExpCode code = irregexp::CompilePattern(
       cx, allocScope.alloc(), re, &data, input, false /* global() */,
@@ -1081,6 +1098,21 @@ RegExpRunStatus RegExpShared::execute(JSContext* cx,
     return RegExpRunStatus_Success;
   }
 
+  // Jump straight to the first position where the literal prefix occurs.
+  // Every match has to start there, and the compiled code still sees the
+  // whole input so assertions looking behind the start index are unaffected.
+  if (re->literalPrefix) {
+    MOZ_ASSERT(!re->sticky());
+    if (start + re->literalPrefix->length() > length) {
+      return RegExpRunStatus_Success_NotFound;
+    }
+    int res = StringFindPattern(input, re->literalPrefix, start);
+    if (res == -1) {
+      return RegExpRunStatus_Success_NotFound;
+    }
+    start = size_t(res);
+  }
+
   do {
     jit::JitCode* code = re->compilation(mode, input->hasLatin1Chars()).jitCode;
     if (!code) {
@@ -87,6 +87,12 @@ class RegExpShared : public gc::TenuredCell {
   /* Source to the RegExp, for lazy compilation. */
   GCPtr<JSAtom*> source;
 
+  /*
+   * Literal code units every match must begin with, or null. Used to skip
+   * ahead to candidate positions before running the compiled matcher.
+   */
+  GCPtr<JSAtom*> literalPrefix;
+
   JS::RegExpFlags flags;
   bool canStringMatch;
   size_t parenCount;
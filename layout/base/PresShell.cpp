@@ -214,6 +214,8 @@ typedef ScrollableLayerGuid::ViewID ViewID;
 
 PresShell::CapturingContentInfo PresShell::sCapturingContentInfo;
 
+PROFILER_DEFINE_HOT_COUNT(Reflows, "Layout", "Number of PresShell reflows")
+
 // RangePaintInfo is used to paint ranges to offscreen buffers
 struct RangePaintInfo {
   RefPtr<nsRange> mRange;
@@ -9116,6 +9118,7 @@ bool PresShell::DoReflow(nsIFrame* target, bool aInterruptible,
       "Reflow", LAYOUT_Reflow,
       uri ? uri->GetSpecOrDefault() : NS_LITERAL_CSTRING("N/A"));
 #endif
+  AUTO_PROFILER_HOT_COUNT(Reflows, 1);
 
   gfxTextPerfMetrics* tp = mPresContext->GetTextPerfMetrics();
   TimeStamp timeStart;
@@ -31,6 +31,8 @@
 #include "nsContentPolicyUtils.h"
 #include "nsIHttpChannel.h"
 #include "nsIHttpChannelInternal.h"
+#include "nsICacheInfoChannel.h"
+#include "nsILoadGroup.h"
 #include "nsIClassOfService.h"
 #include "nsIScriptError.h"
 #include "nsMimeTypes.h"
@@ -51,6 +53,7 @@
 #include "mozilla/StyleSheetInlines.h"
 #include "mozilla/ConsoleReportCollector.h"
 #include "mozilla/ServoUtils.h"
+#include "mozilla/css/SharedStyleSheetCache.h"
 #include "mozilla/css/StreamLoader.h"
 #include "ReferrerInfo.h"
 
@@ -175,6 +178,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader, const nsAString& aTitle,
       mIsCrossOriginNoCORS(false),
       mBlockResourceTiming(false),
       mLoadFailed(false),
+      mExpirationTime(0),
       mOwningElement(aOwningElement),
       mObserver(aObserver),
       mLoaderPrincipal(aLoaderPrincipal),
@@ -209,6 +213,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader, nsIURI* aURI, StyleSheet* aSheet,
       mIsCrossOriginNoCORS(false),
       mBlockResourceTiming(false),
       mLoadFailed(false),
+      mExpirationTime(0),
       mOwningElement(nullptr),
       mObserver(aObserver),
       mLoaderPrincipal(aLoaderPrincipal),
@@ -252,6 +257,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader, nsIURI* aURI, StyleSheet* aSheet,
       mIsCrossOriginNoCORS(false),
       mBlockResourceTiming(false),
       mLoadFailed(false),
+      mExpirationTime(0),
       mOwningElement(nullptr),
       mObserver(aObserver),
       mLoaderPrincipal(aLoaderPrincipal),
@@ -740,6 +746,16 @@ nsresult SheetLoadData::VerifySheetReadyToParse(nsresult aStatus,
     }
   }
 
+  // Now that we know the sheet is usable by any document, remember how long
+  // the HTTP cache considers it fresh, so that it can be shared with other
+  // documents until then.
+  if (validType) {
+    nsCOMPtr<nsICacheInfoChannel> cacheInfo(do_QueryInterface(aChannel));
+    if (cacheInfo) {
+      Unused << cacheInfo->GetCacheTokenExpirationTime(&mExpirationTime);
+    }
+  }
+
   SRIMetadata sriMetadata;
   mSheet->GetIntegrity(sriMetadata);
   if (!sriMetadata.IsEmpty()) {
@@ -857,6 +873,27 @@ nsresult Loader::CheckContentPolicy(nsIPrincipal* aLoadingPrincipal,
   return NS_OK;
 }
 
+/**
+ * Whether the sheets loaded for aDocument can come from, and go into, the
+ * SharedStyleSheetCache.  Non-document loads and reloads (which want fresh
+ * sheets) don't use it.
+ */
+static bool CanUseSharedStyleSheetCache(Document* aDocument) {
+  if (!aDocument) {
+    return false;
+  }
+
+  nsCOMPtr<nsILoadGroup> loadGroup = aDocument->GetDocumentLoadGroup();
+  if (!loadGroup) {
+    return true;
+  }
+
+  nsLoadFlags loadFlags = nsIRequest::LOAD_NORMAL;
+  loadGroup->GetLoadFlags(&loadFlags);
+  return !(loadFlags &
+           (nsIRequest::LOAD_BYPASS_CACHE | nsIRequest::VALIDATE_ALWAYS));
+}
+
 /**
  * CreateSheet() creates a CSSStyleSheet object for the given URI,
  * if any.  If there is no URI given, we just create a new style sheet
@@ -912,6 +949,17 @@ nsresult Loader::CreateSheet(nsIURI* aURI, nsIContent* aLinkingContent,
       fromCompleteSheets = !!sheet;
     }
 
+    if (!sheet && aIntegrity.IsEmpty() && !IsChromeURI(aURI) &&
+        CanUseSharedStyleSheetCache(mDocument)) {
+      // Then the style sheets shared with other documents.
+      SharedStyleSheetKey key(
+          URIPrincipalReferrerPolicyAndCORSModeHashKey(
+              aURI, aLoaderPrincipal, aCORSMode, aReferrerPolicy),
+          mCompatMode);
+      sheet = SharedStyleSheetCache::Lookup(&key);
+      LOG(("  From shared cache: %p", sheet.get()));
+    }
+
     if (sheet) {
       // This sheet came from the XUL cache or our per-document hashtable; it
       // better be a complete sheet.
@@ -1763,6 +1811,16 @@ void Loader::DoSheetComplete(SheetLoadData* aLoadData,
       NS_ASSERTION(sheet->IsComplete(),
                    "Should only be caching complete sheets");
       mSheets->mCompleteSheets.Put(&key, sheet);
+
+      SRIMetadata sriMetadata;
+      sheet->GetIntegrity(sriMetadata);
+      if (aLoadData->mExpirationTime && !aLoadData->mUseSystemPrincipal &&
+          sriMetadata.IsEmpty() && !sheet->HasForcedUniqueInner() &&
+          !sheet->GetFirstChild() && CanUseSharedStyleSheetCache(mDocument)) {
+        SharedStyleSheetKey sharedKey(key, mCompatMode);
+        SharedStyleSheetCache::Insert(&sharedKey, sheet,
+                                      aLoadData->mExpirationTime);
+      }
 #ifdef MOZ_XUL
     }
 #endif
@@ -41,6 +41,9 @@
 using namespace mozilla;
 using namespace mozilla::dom;
 
+PROFILER_DEFINE_HOT_COUNT(StyleTraversals, "Style",
+                          "Number of document style traversals")
+
 #ifdef DEBUG
 bool ServoStyleSet::IsCurrentThreadInServoTraversal() {
   return sInServoTraversal && (NS_IsMainThread() || Servo_IsWorkerThread());
@@ -721,6 +724,7 @@ bool ServoStyleSet::StyleDocument(ServoTraversalFlags aFlags) {
     return false;
   }
 
+  AUTO_PROFILER_HOT_COUNT(StyleTraversals, 1);
   PreTraverse(aFlags);
   AutoPrepareTraversal guard(this);
   const SnapshotTable& snapshots = Snapshots();
@@ -0,0 +1,168 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/css/SharedStyleSheetCache.h"
+
+#include "mozilla/Services.h"
+#include "mozilla/StaticPtr.h"
+#include "mozilla/StyleSheet.h"
+#include "mozilla/StyleSheetInlines.h"
+#include "mozilla/UniquePtr.h"
+#include "nsIObserverService.h"
+#include "prtime.h"
+
+// Bound on the number of cached sheets. Expired entries are dropped first when
+// it is reached.
+#define MAX_SHARED_SHEETS 128
+
+namespace mozilla {
+namespace css {
+
+static StaticRefPtr<SharedStyleSheetCache> gSharedStyleSheetCache;
+static bool gSharedStyleSheetCacheShutdown = false;
+
+static uint32_t NowInSeconds() { return uint32_t(PR_Now() / PR_USEC_PER_SEC); }
+
+NS_IMPL_ISUPPORTS(SharedStyleSheetCache, nsIObserver, nsIMemoryReporter)
+
+SharedStyleSheetCache::SharedStyleSheetCache() {
+  nsCOMPtr<nsIObserverService> obsSvc = services::GetObserverService();
+  if (obsSvc) {
+    obsSvc->AddObserver(this, "memory-pressure", false);
+    obsSvc->AddObserver(this, "xpcom-shutdown", false);
+  }
+  RegisterWeakMemoryReporter(this);
+}
+
+SharedStyleSheetCache::~SharedStyleSheetCache() {
+  UnregisterWeakMemoryReporter(this);
+}
+
+/* static */
+SharedStyleSheetCache* SharedStyleSheetCache::GetOrCreate() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!gSharedStyleSheetCache) {
+    if (gSharedStyleSheetCacheShutdown) {
+      return nullptr;
+    }
+    gSharedStyleSheetCache = new SharedStyleSheetCache();
+  }
+
+  return gSharedStyleSheetCache;
+}
+
+/* static */
+StyleSheet* SharedStyleSheetCache::Lookup(SharedStyleSheetKey* aKey) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!gSharedStyleSheetCache) {
+    return nullptr;
+  }
+
+  Entry* entry = gSharedStyleSheetCache->mEntries.Get(aKey);
+  if (!entry) {
+    return nullptr;
+  }
+
+  if (entry->mExpirationTime <= NowInSeconds()) {
+    gSharedStyleSheetCache->mEntries.Remove(aKey);
+    return nullptr;
+  }
+
+  return entry->mSheet;
+}
+
+/* static */
+void SharedStyleSheetCache::Insert(SharedStyleSheetKey* aKey,
+                                   StyleSheet* aSheet,
+                                   uint32_t aExpirationTime) {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(aSheet->IsComplete());
+
+  // See the comment in the header about child sheets.
+  if (aSheet->GetFirstChild()) {
+    return;
+  }
+
+  uint32_t now = NowInSeconds();
+  if (aExpirationTime <= now) {
+    return;
+  }
+
+  SharedStyleSheetCache* cache = GetOrCreate();
+  if (!cache) {
+    return;
+  }
+
+  if (cache->mEntries.Count() >= MAX_SHARED_SHEETS) {
+    cache->RemoveExpiredEntries(now);
+    if (cache->mEntries.Count() >= MAX_SHARED_SHEETS) {
+      return;
+    }
+  }
+
+  RefPtr<StyleSheet> clone = aSheet->Clone(nullptr, nullptr, nullptr, nullptr);
+  if (!clone) {
+    return;
+  }
+
+  auto entry = MakeUnique<Entry>();
+  entry->mSheet = std::move(clone);
+  entry->mExpirationTime = aExpirationTime;
+  cache->mEntries.Put(aKey, entry.release());
+}
+
+void SharedStyleSheetCache::RemoveExpiredEntries(uint32_t aNow) {
+  for (auto iter = mEntries.Iter(); !iter.Done(); iter.Next()) {
+    if (iter.Data()->mExpirationTime <= aNow) {
+      iter.Remove();
+    }
+  }
+}
+
+NS_IMETHODIMP
+SharedStyleSheetCache::Observe(nsISupports* aSubject, const char* aTopic,
+                               const char16_t* aData) {
+  if (!strcmp(aTopic, "memory-pressure")) {
+    mEntries.Clear();
+  } else if (!strcmp(aTopic, "xpcom-shutdown")) {
+    nsCOMPtr<nsIObserverService> obsSvc = services::GetObserverService();
+    if (obsSvc) {
+      obsSvc->RemoveObserver(this, "memory-pressure");
+      obsSvc->RemoveObserver(this, "xpcom-shutdown");
+    }
+    mEntries.Clear();
+    gSharedStyleSheetCacheShutdown = true;
+    gSharedStyleSheetCache = nullptr;
+  }
+  return NS_OK;
+}
+
+MOZ_DEFINE_MALLOC_SIZE_OF(SharedStyleSheetCacheMallocSizeOf)
+
+NS_IMETHODIMP
+SharedStyleSheetCache::CollectReports(nsIHandleReportCallback* aHandleReport,
+                                      nsISupports* aData, bool aAnonymize) {
+  MOZ_COLLECT_REPORT("explicit/layout/style-sheet-cache/document-shared",
+                     KIND_HEAP, UNITS_BYTES,
+                     SizeOfIncludingThis(SharedStyleSheetCacheMallocSizeOf),
+                     "Memory used for author style sheets that are shared "
+                     "between documents.");
+  return NS_OK;
+}
+
+size_t SharedStyleSheetCache::SizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  size_t n = aMallocSizeOf(this);
+  n += mEntries.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (auto iter = mEntries.ConstIter(); !iter.Done(); iter.Next()) {
+    n += aMallocSizeOf(iter.Data());
+    n += iter.Data()->mSheet->SizeOfIncludingThis(aMallocSizeOf);
+  }
+  return n;
+}
+
+}  // namespace css
+}  // namespace mozilla
@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_css_SharedStyleSheetCache_h
+#define mozilla_css_SharedStyleSheetCache_h
+
+#include "mozilla/css/Loader.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/MemoryReporting.h"
+#include "nsCompatibility.h"
+#include "nsIMemoryReporter.h"
+#include "nsIObserver.h"
+#include "nsClassHashtable.h"
+
+namespace mozilla {
+
+class StyleSheet;
+
+namespace css {
+
+// The key of the SharedStyleSheetCache: the key of the per-document complete
+// sheets plus the compatibility mode of the loader, since quirks mode changes
+// how some declarations are parsed.
+class SharedStyleSheetKey
+    : public URIPrincipalReferrerPolicyAndCORSModeHashKey {
+ public:
+  typedef SharedStyleSheetKey* KeyType;
+  typedef const SharedStyleSheetKey* KeyTypePointer;
+
+  explicit SharedStyleSheetKey(const SharedStyleSheetKey* aKey)
+      : URIPrincipalReferrerPolicyAndCORSModeHashKey(aKey),
+        mCompatMode(aKey->mCompatMode) {}
+
+  SharedStyleSheetKey(const URIPrincipalReferrerPolicyAndCORSModeHashKey& aKey,
+                      nsCompatibility aCompatMode)
+      : URIPrincipalReferrerPolicyAndCORSModeHashKey(&aKey),
+        mCompatMode(aCompatMode) {}
+
+  SharedStyleSheetKey(SharedStyleSheetKey&& aToMove)
+      : URIPrincipalReferrerPolicyAndCORSModeHashKey(std::move(aToMove)),
+        mCompatMode(aToMove.mCompatMode) {}
+
+  SharedStyleSheetKey* GetKey() const {
+    return const_cast<SharedStyleSheetKey*>(this);
+  }
+  const SharedStyleSheetKey* GetKeyPointer() const { return this; }
+
+  bool KeyEquals(const SharedStyleSheetKey* aKey) const {
+    return mCompatMode == aKey->mCompatMode &&
+           URIPrincipalReferrerPolicyAndCORSModeHashKey::KeyEquals(aKey);
+  }
+
+  static const SharedStyleSheetKey* KeyToPointer(SharedStyleSheetKey* aKey) {
+    return aKey;
+  }
+  static PLDHashNumber HashKey(const SharedStyleSheetKey* aKey) {
+    return AddToHash(URIPrincipalReferrerPolicyAndCORSModeHashKey::HashKey(aKey),
+                     uint32_t(aKey->mCompatMode));
+  }
+
+  enum { ALLOW_MEMMOVE = true };
+
+ private:
+  nsCompatibility mCompatMode;
+};
+
+// Process-wide cache of complete author style sheets, so that documents
+// loading the same style sheet (for example, many same-origin iframes) share
+// its parsed contents instead of fetching and parsing it again.
+//
+// The cached sheets are detached clones: they share their inner with the
+// sheets handed out to documents, and StyleSheet::EnsureUniqueInner gives any
+// sheet that gets modified through CSSOM its own copy. An entry is only used
+// until the expiration time of the HTTP cache entry it was parsed from.
+//
+// Sheets with @import rules are never cached: their child sheets went through
+// the content policy and CSP checks of the document that loaded them, and a
+// clone would hand them to other documents without checking them again.
+//
+// Main thread only.
+class SharedStyleSheetCache final : public nsIObserver,
+                                    public nsIMemoryReporter {
+ public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_NSIOBSERVER
+  NS_DECL_NSIMEMORYREPORTER
+
+  // Returns a complete sheet which can be cloned for aKey, if any.
+  static StyleSheet* Lookup(SharedStyleSheetKey* aKey);
+
+  // Caches a clone of aSheet until aExpirationTime, in seconds since the
+  // epoch.
+  static void Insert(SharedStyleSheetKey* aKey, StyleSheet* aSheet,
+                     uint32_t aExpirationTime);
+
+ private:
+  struct Entry {
+    RefPtr<StyleSheet> mSheet;
+    uint32_t mExpirationTime;
+  };
+
+  SharedStyleSheetCache();
+  ~SharedStyleSheetCache();
+
+  static SharedStyleSheetCache* GetOrCreate();
+
+  void RemoveExpiredEntries(uint32_t aNow);
+  size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const;
+
+  nsClassHashtable<SharedStyleSheetKey, Entry> mEntries;
+};
+
+}  // namespace css
+}  // namespace mozilla
+
+#endif  // mozilla_css_SharedStyleSheetCache_h
@@ -174,6 +174,11 @@ class SheetLoadData final : public nsIRunnable, public nsIThreadObserver {
   // to true if this load, or the load of any descendant import, fails.
   bool mLoadFailed : 1;
 
+  // The expiration time of the HTTP cache entry the sheet was loaded from, in
+  // seconds since the epoch, or 0 if the sheet must not be shared with other
+  // documents.
+  uint32_t mExpirationTime;
+
   // This is the element that imported the sheet.  Needed to get the
   // charset set on it and to fire load/error events.
   nsCOMPtr<nsIStyleSheetLinkingElement> mOwningElement;
@@ -0,0 +1,218 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+
+#include "mozilla/BasePrincipal.h"
+#include "mozilla/CORSMode.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/ServoCSSRuleList.h"
+#include "mozilla/StyleSheet.h"
+#include "mozilla/StyleSheetInlines.h"
+#include "mozilla/css/Loader.h"
+#include "mozilla/css/SharedStyleSheetCache.h"
+#include "mozilla/dom/Document.h"
+#include "mozilla/dom/SRIMetadata.h"
+#include "nsContentUtils.h"
+#include "nsHTMLDocument.h"
+#include "nsNetUtil.h"
+#include "prtime.h"
+
+using namespace mozilla;
+using namespace mozilla::css;
+using namespace mozilla::dom;
+
+// An HTML document for aOrigin in the given compatibility mode.
+static already_AddRefed<Document> NewDocument(const char* aOrigin,
+                                              nsCompatibility aCompatMode) {
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), aOrigin);
+  nsCOMPtr<nsIPrincipal> principal =
+      BasePrincipal::CreateCodebasePrincipal(uri, OriginAttributes());
+  RefPtr<Document> doc;
+  nsresult rv = NS_NewDOMDocument(getter_AddRefs(doc),
+                                  EmptyString(),  // aNamespaceURI
+                                  EmptyString(),  // aQualifiedName
+                                  nullptr,        // aDoctype
+                                  uri, uri, principal,
+                                  false,    // aLoadedAsData
+                                  nullptr,  // aEventObject
+                                  DocumentFlavorHTML);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return nullptr;
+  }
+  doc->AsHTMLDocument()->SetCompatibilityMode(aCompatMode);
+  return doc.forget();
+}
+
+// A complete author sheet for aURI, as the loader of aDoc would have parsed
+// it.
+static already_AddRefed<StyleSheet> NewCompleteSheet(Document* aDoc,
+                                                     nsIURI* aURI,
+                                                     const char* aText) {
+  RefPtr<StyleSheet> sheet = new StyleSheet(
+      eAuthorSheetFeatures, CORS_NONE, net::RP_Unset, SRIMetadata());
+  sheet->SetURIs(aURI, aURI, aURI);
+  sheet->SetPrincipal(aDoc->NodePrincipal());
+  sheet->ParseSheetSync(aDoc->CSSLoader(), nsDependentCString(aText),
+                        nullptr, 0);
+  sheet->SetComplete();
+  return sheet.forget();
+}
+
+// The key Loader::CreateSheet uses when aDoc links aURI.
+static SharedStyleSheetKey KeyFor(Document* aDoc, nsIURI* aURI,
+                                  CORSMode aCORSMode = CORS_NONE) {
+  return SharedStyleSheetKey(
+      URIPrincipalReferrerPolicyAndCORSModeHashKey(
+          aURI, aDoc->NodePrincipal(), aCORSMode, net::RP_Unset),
+      aDoc->CSSLoader()->GetCompatibilityMode());
+}
+
+static uint32_t InAnHour() {
+  return uint32_t(PR_Now() / PR_USEC_PER_SEC) + 3600;
+}
+
+// Reading the rules of a sheet gives it a unique inner, so count them on a
+// clone to leave aSheet as it is.
+static uint32_t RuleCount(StyleSheet* aSheet) {
+  RefPtr<StyleSheet> copy = aSheet->Clone(nullptr, nullptr, nullptr, nullptr);
+  return copy->GetCssRulesInternal()->Length();
+}
+
+TEST(SharedStyleSheetCache, SharedBetweenMatchingDocuments)
+{
+  RefPtr<Document> first =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  RefPtr<Document> second =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(first && second);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://a.example/shared.css");
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(first, uri, "p { color: red }");
+
+  SharedStyleSheetKey firstKey = KeyFor(first, uri);
+  SharedStyleSheetCache::Insert(&firstKey, sheet, InAnHour());
+
+  SharedStyleSheetKey secondKey = KeyFor(second, uri);
+  StyleSheet* cached = SharedStyleSheetCache::Lookup(&secondKey);
+  ASSERT_TRUE(cached);
+  ASSERT_NE(cached, sheet.get());
+  ASSERT_EQ(RuleCount(cached), 1u);
+}
+
+TEST(SharedStyleSheetCache, CompatModeNotShared)
+{
+  RefPtr<Document> quirks =
+      NewDocument("https://a.example/", eCompatibility_NavQuirks);
+  RefPtr<Document> standards =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(quirks && standards);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://a.example/compat.css");
+  // Quirks mode accepts the unitless length; standards mode drops it.
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(quirks, uri, "p { width: 10 }");
+
+  SharedStyleSheetKey quirksKey = KeyFor(quirks, uri);
+  SharedStyleSheetCache::Insert(&quirksKey, sheet, InAnHour());
+  ASSERT_TRUE(SharedStyleSheetCache::Lookup(&quirksKey));
+
+  SharedStyleSheetKey standardsKey = KeyFor(standards, uri);
+  ASSERT_FALSE(SharedStyleSheetCache::Lookup(&standardsKey));
+}
+
+TEST(SharedStyleSheetCache, PrincipalNotShared)
+{
+  RefPtr<Document> a =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  RefPtr<Document> b =
+      NewDocument("https://b.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(a && b);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://cdn.example/principal.css");
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(a, uri, "p { color: red }");
+
+  SharedStyleSheetKey aKey = KeyFor(a, uri);
+  SharedStyleSheetCache::Insert(&aKey, sheet, InAnHour());
+  ASSERT_TRUE(SharedStyleSheetCache::Lookup(&aKey));
+
+  SharedStyleSheetKey bKey = KeyFor(b, uri);
+  ASSERT_FALSE(SharedStyleSheetCache::Lookup(&bKey));
+}
+
+TEST(SharedStyleSheetCache, CORSModeNotShared)
+{
+  RefPtr<Document> doc =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(doc);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://cdn.example/cors.css");
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(doc, uri, "p { color: red }");
+
+  SharedStyleSheetKey key = KeyFor(doc, uri);
+  SharedStyleSheetCache::Insert(&key, sheet, InAnHour());
+
+  SharedStyleSheetKey anonymousKey = KeyFor(doc, uri, CORS_ANONYMOUS);
+  ASSERT_FALSE(SharedStyleSheetCache::Lookup(&anonymousKey));
+}
+
+TEST(SharedStyleSheetCache, ExpiredNotShared)
+{
+  RefPtr<Document> doc =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(doc);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://a.example/expired.css");
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(doc, uri, "p { color: red }");
+
+  SharedStyleSheetKey key = KeyFor(doc, uri);
+  SharedStyleSheetCache::Insert(&key, sheet,
+                                uint32_t(PR_Now() / PR_USEC_PER_SEC));
+  ASSERT_FALSE(SharedStyleSheetCache::Lookup(&key));
+}
+
+TEST(SharedStyleSheetCache, CSSOMMutationDoesNotLeak)
+{
+  RefPtr<Document> first =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  RefPtr<Document> second =
+      NewDocument("https://a.example/", eCompatibility_FullStandards);
+  ASSERT_TRUE(first && second);
+
+  nsCOMPtr<nsIURI> uri;
+  NS_NewURI(getter_AddRefs(uri), "https://a.example/cssom.css");
+  RefPtr<StyleSheet> sheet = NewCompleteSheet(first, uri, "p { color: red }");
+
+  SharedStyleSheetKey key = KeyFor(first, uri);
+  SharedStyleSheetCache::Insert(&key, sheet, InAnHour());
+
+  // Each document gets its own clone of the cached sheet, as
+  // Loader::CreateSheet hands out.
+  StyleSheet* cached = SharedStyleSheetCache::Lookup(&key);
+  ASSERT_TRUE(cached);
+  RefPtr<StyleSheet> firstCopy =
+      cached->Clone(nullptr, nullptr, nullptr, nullptr);
+
+  ErrorResult rv;
+  firstCopy->InsertRule(NS_LITERAL_STRING("div { color: blue }"), 0,
+                        *nsContentUtils::GetSystemPrincipal(), rv);
+  ASSERT_FALSE(rv.Failed());
+  ASSERT_EQ(RuleCount(firstCopy), 2u);
+
+  SharedStyleSheetKey secondKey = KeyFor(second, uri);
+  cached = SharedStyleSheetCache::Lookup(&secondKey);
+  ASSERT_TRUE(cached);
+  ASSERT_FALSE(cached->HasForcedUniqueInner());
+  ASSERT_NE(cached->RawContents(), firstCopy->RawContents());
+  ASSERT_EQ(RuleCount(cached), 1u);
+
+  RefPtr<StyleSheet> secondCopy =
+      cached->Clone(nullptr, nullptr, nullptr, nullptr);
+  ASSERT_EQ(RuleCount(secondCopy), 1u);
+}
@@ -485,38 +485,71 @@ SVGBBox SVGGeometryFrame::GetBBoxContribution(const Matrix& aToBBoxUserspace,
     bbox = simpleBounds;
   } else {
     // Get the bounds using a Moz2D Path object (more expensive):
-    RefPtr<DrawTarget> tmpDT;
+    RefPtr<Path> pathInUserSpace;
+    Rect pathBBoxExtents;
+
+    // The user space bounds of the path only change with its geometry, so for
+    // transforms that keep rectangles axis-aligned we can map the bounds
+    // cached on the element, rather than transforming and measuring the path
+    // again every time only the transform changes.
+    bool useUserSpaceBounds = aToBBoxUserspace.PreservesAxisAlignedRectangles();
+    Maybe<Rect> userSpaceBounds;
+    if (useUserSpaceBounds) {
+      userSpaceBounds = element->GetCachedPathBounds();
+    }
+
+    if (!userSpaceBounds) {
+      RefPtr<DrawTarget> tmpDT;
 #ifdef XP_WIN
-    // Unfortunately D2D backed DrawTarget produces bounds with rounding errors
-    // when whole number results are expected, even in the case of trivial
-    // calculations. To avoid that and meet the expectations of web content we
-    // have to use a CAIRO DrawTarget. The most efficient way to do that is to
-    // wrap the cached cairo_surface_t from ScreenReferenceSurface():
-    RefPtr<gfxASurface> refSurf =
-        gfxPlatform::GetPlatform()->ScreenReferenceSurface();
-    tmpDT = gfxPlatform::GetPlatform()->CreateDrawTargetForSurface(
-        refSurf, IntSize(1, 1));
+      // Unfortunately D2D backed DrawTarget produces bounds with rounding
+      // errors when whole number results are expected, even in the case of
+      // trivial calculations. To avoid that and meet the expectations of web
+      // content we have to use a CAIRO DrawTarget. The most efficient way to
+      // do that is to wrap the cached cairo_surface_t from
+      // ScreenReferenceSurface():
+      RefPtr<gfxASurface> refSurf =
+          gfxPlatform::GetPlatform()->ScreenReferenceSurface();
+      tmpDT = gfxPlatform::GetPlatform()->CreateDrawTargetForSurface(
+          refSurf, IntSize(1, 1));
 #else
-    tmpDT = gfxPlatform::GetPlatform()->ScreenReferenceDrawTarget();
+      tmpDT = gfxPlatform::GetPlatform()->ScreenReferenceDrawTarget();
 #endif
 
-    FillRule fillRule = nsSVGUtils::ToFillRule(
-        (GetStateBits() & NS_STATE_SVG_CLIPPATH_CHILD) ? StyleSVG()->mClipRule
-                                                       : StyleSVG()->mFillRule);
-    RefPtr<Path> pathInUserSpace = element->GetOrBuildPath(tmpDT, fillRule);
-    if (!pathInUserSpace) {
-      return bbox;
-    }
-    RefPtr<Path> pathInBBoxSpace;
-    if (aToBBoxUserspace.IsIdentity()) {
-      pathInBBoxSpace = pathInUserSpace;
-    } else {
-      RefPtr<PathBuilder> builder =
-          pathInUserSpace->TransformedCopyToBuilder(aToBBoxUserspace, fillRule);
-      pathInBBoxSpace = builder->Finish();
-      if (!pathInBBoxSpace) {
+      FillRule fillRule = nsSVGUtils::ToFillRule(
+          (GetStateBits() & NS_STATE_SVG_CLIPPATH_CHILD)
+              ? StyleSVG()->mClipRule
+              : StyleSVG()->mFillRule);
+      pathInUserSpace = element->GetOrBuildPath(tmpDT, fillRule);
+      if (!pathInUserSpace) {
         return bbox;
       }
+
+      if (useUserSpaceBounds) {
+        pathBBoxExtents = pathInUserSpace->GetBounds();
+      } else {
+        RefPtr<PathBuilder> builder = pathInUserSpace->TransformedCopyToBuilder(
+            aToBBoxUserspace, fillRule);
+        RefPtr<Path> pathInBBoxSpace = builder->Finish();
+        if (!pathInBBoxSpace) {
+          return bbox;
+        }
+        pathBBoxExtents = pathInBBoxSpace->GetBounds();
+      }
+
+      if (!pathBBoxExtents.IsFinite()) {
+        // This can happen in the case that we only have a move-to command in
+        // the path commands, in which case we know nothing gets rendered.
+        return bbox;
+      }
+
+      if (useUserSpaceBounds) {
+        element->SetCachedPathBounds(pathBBoxExtents);
+        userSpaceBounds = Some(pathBBoxExtents);
+      }
+    }
+
+    if (userSpaceBounds) {
+      pathBBoxExtents = aToBBoxUserspace.TransformBounds(*userSpaceBounds);
     }
 
     // Be careful when replacing the following logic to get the fill and stroke
@@ -531,13 +564,6 @@ SVGBBox SVGGeometryFrame::GetBBoxContribution(const Matrix& aToBBoxUserspace,
     // # If the stroke is very thin, cairo won't paint any stroke, and so the
     //   stroke bounds that it will return will be empty.
 
-    Rect pathBBoxExtents = pathInBBoxSpace->GetBounds();
-    if (!pathBBoxExtents.IsFinite()) {
-      // This can happen in the case that we only have a move-to command in the
-      // path commands, in which case we know nothing gets rendered.
-      return bbox;
-    }
-
     // Account for fill:
     if (getFill) {
       bbox = pathBBoxExtents;
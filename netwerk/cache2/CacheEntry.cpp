@@ -27,6 +27,7 @@
 #include "nsThreadUtils.h"
 #include "mozilla/Telemetry.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/ProfilerCounts.h"
 #include <math.h>
 #include <algorithm>
 
@@ -41,6 +42,9 @@ static uint32_t const ENTRY_NEEDS_REVALIDATION =
 static uint32_t const ENTRY_NOT_WANTED =
     nsICacheEntryOpenCallback::ENTRY_NOT_WANTED;
 
+PROFILER_DEFINE_HOT_COUNT(CacheEntryOpens, "Network",
+                          "Number of cache2 entry opens")
+
 NS_IMPL_ISUPPORTS(CacheEntryHandle, nsICacheEntry)
 
 // CacheEntryHandle
@@ -299,6 +303,8 @@ void CacheEntry::AsyncOpen(nsICacheEntryOpenCallback* aCallback,
   LOG(("CacheEntry::AsyncOpen [this=%p, state=%s, flags=%d, callback=%p]", this,
        StateString(mState), aFlags, aCallback));
 
+  AUTO_PROFILER_HOT_COUNT(CacheEntryOpens, 1);
+
   bool readonly = aFlags & nsICacheStorage::OPEN_READONLY;
   bool bypassIfBusy = aFlags & nsICacheStorage::OPEN_BYPASS_IF_BUSY;
   bool truncate = aFlags & nsICacheStorage::OPEN_TRUNCATE;
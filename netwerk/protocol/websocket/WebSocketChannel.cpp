@@ -10,7 +10,10 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/EndianUtils.h"
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/ScopeExit.h"
+#include "mozilla/SSE.h"
 #include "mozilla/net/WebSocketEventService.h"
+#include "mozilla/net/WebSocketMessageBatch.h"
 
 #include "nsIURI.h"
 #include "nsIURIMutator.h"
@@ -69,6 +72,14 @@
 // dupe one constant we need from it
 #define CLOSE_GOING_AWAY 1001
 
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+namespace mozilla {
+namespace SSE2 {
+uint64_t ApplyWebSocketMask(uint32_t aMaskWord, uint8_t* aData, uint64_t aLen);
+}  // namespace SSE2
+}  // namespace mozilla
+#endif
+
 using namespace mozilla;
 using namespace mozilla::net;
 
@@ -577,6 +588,71 @@ class CallOnMessageAvailable final : public nsIRunnable {
 };
 NS_IMPL_ISUPPORTS(CallOnMessageAvailable, nsIRunnable)
 
+//-----------------------------------------------------------------------------
+// CallOnMessagesAvailable
+//-----------------------------------------------------------------------------
+
+// Delivers every message from one socket read in a single runnable. Each
+// message is still passed to the listener separately and in order. A listener
+// implementing WebSocketMessageBatchListener is told where the read starts
+// and ends, so it can forward the messages together.
+class CallOnMessagesAvailable final : public nsIRunnable {
+ public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  CallOnMessagesAvailable(
+      WebSocketChannel* aChannel,
+      nsTArray<WebSocketChannel::IncomingMessage>&& aMessages)
+      : mChannel(aChannel),
+        mListenerMT(aChannel->mListenerMT),
+        mMessages(std::move(aMessages)) {}
+
+  NS_IMETHOD Run() override {
+    MOZ_ASSERT(mChannel->IsOnTargetThread());
+
+    if (!mListenerMT) {
+      return NS_OK;
+    }
+
+    nsCOMPtr<WebSocketMessageBatchListener> batchListener =
+        do_QueryInterface(mListenerMT->mListener);
+    if (batchListener) {
+      batchListener->BeginMessageBatch();
+    }
+
+    for (const WebSocketChannel::IncomingMessage& message : mMessages) {
+      nsresult rv;
+      if (message.mIsBinary) {
+        rv = mListenerMT->mListener->OnBinaryMessageAvailable(
+            mListenerMT->mContext, message.mData);
+      } else {
+        rv = mListenerMT->mListener->OnMessageAvailable(mListenerMT->mContext,
+                                                        message.mData);
+      }
+      if (NS_FAILED(rv)) {
+        LOG(
+            ("OnMessageAvailable or OnBinaryMessageAvailable "
+             "failed with 0x%08" PRIx32,
+             static_cast<uint32_t>(rv)));
+      }
+    }
+
+    if (batchListener) {
+      batchListener->EndMessageBatch();
+    }
+
+    return NS_OK;
+  }
+
+ private:
+  ~CallOnMessagesAvailable() = default;
+
+  RefPtr<WebSocketChannel> mChannel;
+  RefPtr<BaseWebSocketChannel::ListenerAndContextContainer> mListenerMT;
+  nsTArray<WebSocketChannel::IncomingMessage> mMessages;
+};
+NS_IMPL_ISUPPORTS(CallOnMessagesAvailable, nsIRunnable)
+
 //-----------------------------------------------------------------------------
 // CallOnStop
 //-----------------------------------------------------------------------------
@@ -1144,6 +1220,7 @@ WebSocketChannel::WebSocketChannel()
       mDynamicOutputSize(0),
       mDynamicOutput(nullptr),
       mPrivateBrowsing(false),
+      mBatchMessages(false),
       mConnectionLogService(nullptr),
       mMutex("WebSocketChannel::mMutex") {
   MOZ_ASSERT(NS_IsMainThread(), "not main thread");
@@ -1427,6 +1504,10 @@ nsresult WebSocketChannel::ProcessInput(uint8_t* buffer, uint32_t count) {
 
   nsresult rv;
 
+  // Whatever was batched from this read goes out before we return, including
+  // on errors, so it stays ahead of any OnStop.
+  auto flushMessages = MakeScopeExit([&] { FlushIncomingMessages(); });
+
   // The purpose of ping/pong is to actively probe the peer so that an
   // unreachable peer is not mistaken for a period of idleness. This
   // implementation accepts any application level read activity as a sign of
@@ -1667,8 +1748,7 @@ nsresult WebSocketChannel::ProcessInput(uint8_t* buffer, uint32_t count) {
           mService->FrameReceived(mSerial, mInnerWindowID, frame.forget());
         }
 
-        mTargetThread->Dispatch(new CallOnMessageAvailable(this, utf8Data, -1),
-                                NS_DISPATCH_NORMAL);
+        DeliverIncomingMessage(utf8Data, false);
         if (mConnectionLogService && !mPrivateBrowsing) {
           mConnectionLogService->NewMsgReceived(mHost, mSerial, count);
           LOG(("Added new msg received for %s", mHost.get()));
@@ -1727,6 +1807,7 @@ nsresult WebSocketChannel::ProcessInput(uint8_t* buffer, uint32_t count) {
         }
 
         if (mListenerMT) {
+          FlushIncomingMessages();
           mTargetThread->Dispatch(
               new CallOnServerClose(this, mServerCloseCode, mServerCloseReason),
               NS_DISPATCH_NORMAL);
@@ -1793,9 +1874,7 @@ nsresult WebSocketChannel::ProcessInput(uint8_t* buffer, uint32_t count) {
           mService->FrameReceived(mSerial, mInnerWindowID, frame.forget());
         }
 
-        mTargetThread->Dispatch(
-            new CallOnMessageAvailable(this, binaryData, binaryData.Length()),
-            NS_DISPATCH_NORMAL);
+        DeliverIncomingMessage(binaryData, true);
         // To add the header to 'Networking Dashboard' log
         if (mConnectionLogService && !mPrivateBrowsing) {
           mConnectionLogService->NewMsgReceived(mHost, mSerial, count);
@@ -1853,6 +1932,36 @@ nsresult WebSocketChannel::ProcessInput(uint8_t* buffer, uint32_t count) {
   return NS_OK;
 }
 
+void WebSocketChannel::DeliverIncomingMessage(nsCString& aData,
+                                              bool aIsBinary) {
+  MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+
+  if (!mBatchMessages) {
+    mTargetThread->Dispatch(
+        new CallOnMessageAvailable(this, aData,
+                                   aIsBinary ? int32_t(aData.Length()) : -1),
+        NS_DISPATCH_NORMAL);
+    return;
+  }
+
+  IncomingMessage* message = mIncomingMessages.AppendElement();
+  message->mData.Assign(aData);
+  message->mIsBinary = aIsBinary;
+}
+
+void WebSocketChannel::FlushIncomingMessages() {
+  MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+
+  if (mIncomingMessages.IsEmpty()) {
+    return;
+  }
+
+  mTargetThread->Dispatch(
+      new CallOnMessagesAvailable(this, std::move(mIncomingMessages)),
+      NS_DISPATCH_NORMAL);
+  mIncomingMessages.Clear();
+}
+
 /* static */
 void WebSocketChannel::ApplyMask(uint32_t mask, uint8_t* data, uint64_t len) {
   if (!data || len == 0) return;
@@ -1870,9 +1979,18 @@ void WebSocketChannel::ApplyMask(uint32_t mask, uint8_t* data, uint64_t len) {
 
   // perform mask on full words of data
 
+  NetworkEndian::writeUint32(&mask, mask);
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+  // The mask repeats every 4 bytes, so whole 16 byte blocks can be handled
+  // with the same word. Whatever is left falls through to the loop below.
+  if (len >= 16 && mozilla::supports_sse2()) {
+    uint64_t done = mozilla::SSE2::ApplyWebSocketMask(mask, data, len);
+    data += done;
+    len -= done;
+  }
+#endif
   uint32_t* iData = (uint32_t*)data;
   uint32_t* end = iData + (len / 4);
-  NetworkEndian::writeUint32(&mask, mask);
   for (; iData < end; iData++) *iData ^= mask;
   mask = NetworkEndian::readUint32(&mask);
   data = (uint8_t*)iData;
@@ -3328,6 +3446,11 @@ WebSocketChannel::AsyncOpen(nsIURI* aURI, const nsACString& aOrigin,
     if (NS_SUCCEEDED(rv)) {
       mMaxConcurrentConnections = clamped(intpref, 1, 0xffff);
     }
+    rv = prefService->GetBoolPref("network.websocket.batch-messages",
+                                  &boolpref);
+    if (NS_SUCCEEDED(rv)) {
+      mBatchMessages = boolpref;
+    }
   }
 
   int32_t sessionCount = -1;
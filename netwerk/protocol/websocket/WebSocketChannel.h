@@ -19,10 +19,12 @@
 #include "nsIHttpChannelInternal.h"
 #include "nsIStringStream.h"
 #include "BaseWebSocketChannel.h"
+#include "gtest/MozGtestFriend.h"
 
 #include "nsCOMPtr.h"
 #include "nsString.h"
 #include "nsDeque.h"
+#include "nsTArray.h"
 #include "mozilla/Atomics.h"
 
 class nsIAsyncVerifyRedirectCallback;
@@ -41,6 +43,7 @@ class OutboundEnqueuer;
 class nsWSAdmissionManager;
 class PMCECompression;
 class CallOnMessageAvailable;
+class CallOnMessagesAvailable;
 class CallOnStop;
 class CallOnServerClose;
 class CallAcknowledge;
@@ -130,6 +133,7 @@ class WebSocketChannel : public BaseWebSocketChannel,
   friend class nsWSAdmissionManager;
   friend class FailDelayManager;
   friend class CallOnMessageAvailable;
+  friend class CallOnMessagesAvailable;
   friend class CallOnStop;
   friend class CallOnServerClose;
   friend class CallAcknowledge;
@@ -172,9 +176,12 @@ class WebSocketChannel : public BaseWebSocketChannel,
   void EnsureHdrOut(uint32_t size);
 
   static void ApplyMask(uint32_t mask, uint8_t* data, uint64_t len);
+  FRIEND_TEST(TestWebSocketMask, ApplyMaskMatchesBytewise);
 
   bool IsPersistentFramePtr();
   MOZ_MUST_USE nsresult ProcessInput(uint8_t* buffer, uint32_t count);
+  void DeliverIncomingMessage(nsCString& aData, bool aIsBinary);
+  void FlushIncomingMessages();
   MOZ_MUST_USE bool UpdateReadBuffer(uint8_t* buffer, uint32_t count,
                                      uint32_t accumulatedFragments,
                                      uint32_t* available);
@@ -295,6 +302,16 @@ class WebSocketChannel : public BaseWebSocketChannel,
   uint8_t* mDynamicOutput;
   bool mPrivateBrowsing;
 
+  // When set, messages parsed from one socket read are queued in
+  // mIncomingMessages and handed to the listener by a single runnable.
+  // Read from network.websocket.batch-messages in AsyncOpen.
+  struct IncomingMessage {
+    nsCString mData;
+    bool mIsBinary;
+  };
+  bool mBatchMessages;
+  nsTArray<IncomingMessage> mIncomingMessages;
+
   nsCOMPtr<nsIDashboardEventNotifier> mConnectionLogService;
 
   mozilla::Mutex mMutex;
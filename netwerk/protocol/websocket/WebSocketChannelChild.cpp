@@ -340,6 +340,33 @@ void WebSocketChannelChild::OnBinaryMessageAvailable(const nsCString& aMsg) {
   }
 }
 
+class MessagesEvent : public WebSocketEvent {
+ public:
+  explicit MessagesEvent(nsTArray<WebSocketMessageData>&& aMessages)
+      : mMessages(std::move(aMessages)) {}
+
+  void Run(WebSocketChannelChild* aChild) override {
+    for (const WebSocketMessageData& data : mMessages) {
+      if (!data.isBinary()) {
+        aChild->OnMessageAvailable(data.message());
+      } else {
+        aChild->OnBinaryMessageAvailable(data.message());
+      }
+    }
+  }
+
+ private:
+  nsTArray<WebSocketMessageData> mMessages;
+};
+
+mozilla::ipc::IPCResult WebSocketChannelChild::RecvOnMessagesAvailable(
+    nsTArray<WebSocketMessageData>&& aMessages) {
+  mEventQ->RunOrEnqueue(new EventTargetDispatcher(
+      this, new MessagesEvent(std::move(aMessages)), mTargetThread));
+
+  return IPC_OK();
+}
+
 class AcknowledgeEvent : public WebSocketEvent {
  public:
   explicit AcknowledgeEvent(const uint32_t& aSize) : mSize(aSize) {}
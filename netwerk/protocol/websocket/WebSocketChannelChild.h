@@ -57,6 +57,8 @@ class WebSocketChannelChild final : public BaseWebSocketChannel,
   mozilla::ipc::IPCResult RecvOnStop(const nsresult& aStatusCode);
   mozilla::ipc::IPCResult RecvOnMessageAvailable(const nsCString& aMsg);
   mozilla::ipc::IPCResult RecvOnBinaryMessageAvailable(const nsCString& aMsg);
+  mozilla::ipc::IPCResult RecvOnMessagesAvailable(
+      nsTArray<WebSocketMessageData>&& aMessages);
   mozilla::ipc::IPCResult RecvOnAcknowledge(const uint32_t& aSize);
   mozilla::ipc::IPCResult RecvOnServerClose(const uint16_t& aCode,
                                             const nsCString& aReason);
@@ -89,6 +91,7 @@ class WebSocketChannelChild final : public BaseWebSocketChannel,
   friend class StartEvent;
   friend class StopEvent;
   friend class MessageEvent;
+  friend class MessagesEvent;
   friend class AcknowledgeEvent;
   friend class ServerCloseEvent;
   friend class AsyncOpenFailedEvent;
@@ -18,7 +18,7 @@ namespace mozilla {
 namespace net {
 
 NS_IMPL_ISUPPORTS(WebSocketChannelParent, nsIWebSocketListener,
-                  nsIInterfaceRequestor)
+                  nsIInterfaceRequestor, WebSocketMessageBatchListener)
 
 WebSocketChannelParent::WebSocketChannelParent(
     nsIAuthPromptProvider* aAuthProvider, nsILoadContext* aLoadContext,
@@ -220,6 +220,9 @@ NS_IMETHODIMP
 WebSocketChannelParent::OnMessageAvailable(nsISupports* aContext,
                                            const nsACString& aMsg) {
   LOG(("WebSocketChannelParent::OnMessageAvailable() %p\n", this));
+  if (mPendingMessages.Append(aMsg, false)) {
+    return NS_OK;
+  }
   if (!mIPCOpen || !SendOnMessageAvailable(nsCString(aMsg))) {
     return NS_ERROR_FAILURE;
   }
@@ -230,6 +233,9 @@ NS_IMETHODIMP
 WebSocketChannelParent::OnBinaryMessageAvailable(nsISupports* aContext,
                                                  const nsACString& aMsg) {
   LOG(("WebSocketChannelParent::OnBinaryMessageAvailable() %p\n", this));
+  if (mPendingMessages.Append(aMsg, true)) {
+    return NS_OK;
+  }
   if (!mIPCOpen || !SendOnBinaryMessageAvailable(nsCString(aMsg))) {
     return NS_ERROR_FAILURE;
   }
@@ -255,6 +261,22 @@ WebSocketChannelParent::OnServerClose(nsISupports* aContext, uint16_t code,
   return NS_OK;
 }
 
+//-----------------------------------------------------------------------------
+// WebSocketChannelParent::WebSocketMessageBatchListener
+//-----------------------------------------------------------------------------
+
+void WebSocketChannelParent::BeginMessageBatch() { mPendingMessages.Begin(); }
+
+void WebSocketChannelParent::EndMessageBatch() {
+  mPendingMessages.End([&](const nsTArray<WebSocketMessageData>& aMessages) {
+    LOG(("WebSocketChannelParent::EndMessageBatch() %p sending %zu\n", this,
+         aMessages.Length()));
+    if (mIPCOpen) {
+      Unused << SendOnMessagesAvailable(aMessages);
+    }
+  });
+}
+
 void WebSocketChannelParent::ActorDestroy(ActorDestroyReason why) {
   LOG(("WebSocketChannelParent::ActorDestroy() %p\n", this));
 
@@ -6,6 +6,7 @@
 #define mozilla_net_WebSocketChannelParent_h
 
 #include "mozilla/net/PWebSocketParent.h"
+#include "mozilla/net/WebSocketMessageBatch.h"
 #include "mozilla/net/NeckoParent.h"
 #include "nsIInterfaceRequestor.h"
 #include "nsIWebSocketListener.h"
@@ -21,7 +22,8 @@ namespace net {
 
 class WebSocketChannelParent : public PWebSocketParent,
                                public nsIWebSocketListener,
-                               public nsIInterfaceRequestor {
+                               public nsIInterfaceRequestor,
+                               public WebSocketMessageBatchListener {
   friend class PWebSocketParent;
 
   ~WebSocketChannelParent() = default;
@@ -35,6 +37,9 @@ class WebSocketChannelParent : public PWebSocketParent,
                          nsILoadContext* aLoadContext,
                          PBOverrideStatus aOverrideStatus, uint32_t aSerial);
 
+  void BeginMessageBatch() override;
+  void EndMessageBatch() override;
+
  private:
   mozilla::ipc::IPCResult RecvAsyncOpen(
       const Maybe<URIParams>& aURI, const nsCString& aOrigin,
@@ -60,6 +65,10 @@ class WebSocketChannelParent : public PWebSocketParent,
   nsCOMPtr<nsILoadContext> mLoadContext;
   bool mIPCOpen;
 
+  // Messages the channel delivers from one socket read are collected here and
+  // sent to the child in one OnMessagesAvailable when the read is done.
+  WebSocketMessageBatch mPendingMessages;
+
   uint32_t mSerial;
 };
 
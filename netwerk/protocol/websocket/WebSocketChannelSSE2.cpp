@@ -0,0 +1,42 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// This file should only be compiled if you're on x86 or x86_64.  Additionally,
+// you'll need to compile this file with -msse2 if you're using gcc.
+
+#include <emmintrin.h>
+#include "nscore.h"
+
+namespace mozilla {
+namespace SSE2 {
+
+// XORs the 4-byte masking key into aData 16 bytes at a time. aMaskWord is the
+// key as it is laid out in memory, already rotated to line up with aData.
+// Returns the number of bytes processed, which is aLen rounded down to a
+// multiple of 16; the caller handles the tail.
+uint64_t ApplyWebSocketMask(uint32_t aMaskWord, uint8_t* aData,
+                            uint64_t aLen) {
+  const __m128i mask = _mm_set1_epi32(static_cast<int>(aMaskWord));
+
+  uint64_t i = 0;
+  for (; i + 64 <= aLen; i += 64) {
+    __m128i* p = reinterpret_cast<__m128i*>(aData + i);
+    const __m128i a = _mm_loadu_si128(p);
+    const __m128i b = _mm_loadu_si128(p + 1);
+    const __m128i c = _mm_loadu_si128(p + 2);
+    const __m128i d = _mm_loadu_si128(p + 3);
+    _mm_storeu_si128(p, _mm_xor_si128(a, mask));
+    _mm_storeu_si128(p + 1, _mm_xor_si128(b, mask));
+    _mm_storeu_si128(p + 2, _mm_xor_si128(c, mask));
+    _mm_storeu_si128(p + 3, _mm_xor_si128(d, mask));
+  }
+  for (; i + 16 <= aLen; i += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(aData + i);
+    _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), mask));
+  }
+  return i;
+}
+
+}  // namespace SSE2
+}  // namespace mozilla
@@ -0,0 +1,85 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_net_WebSocketMessageBatch_h
+#define mozilla_net_WebSocketMessageBatch_h
+
+#include "mozilla/net/PWebSocket.h"
+#include "nsISupports.h"
+#include "nsString.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+namespace net {
+
+#define WEBSOCKET_MESSAGE_BATCH_LISTENER_IID         \
+  {                                                  \
+    0x5d3e2a4c, 0x8b71, 0x4f0e, {                    \
+      0x9a, 0x26, 0x3c, 0x1f, 0x74, 0xe8, 0x0b, 0x95 \
+    }                                                \
+  }
+
+// Optionally implemented by an nsIWebSocketListener. When WebSocketChannel
+// delivers every message from one socket read in a single runnable, it calls
+// BeginMessageBatch() before the first OnMessageAvailable or
+// OnBinaryMessageAvailable of that read and EndMessageBatch() after the last.
+class WebSocketMessageBatchListener : public nsISupports {
+ public:
+  NS_DECLARE_STATIC_IID_ACCESSOR(WEBSOCKET_MESSAGE_BATCH_LISTENER_IID)
+
+  virtual void BeginMessageBatch() = 0;
+  virtual void EndMessageBatch() = 0;
+};
+
+NS_DEFINE_STATIC_IID_ACCESSOR(WebSocketMessageBatchListener,
+                              WEBSOCKET_MESSAGE_BATCH_LISTENER_IID)
+
+// Collects the messages WebSocketChannelParent receives between
+// BeginMessageBatch() and EndMessageBatch(), so they can be forwarded to the
+// child in one OnMessagesAvailable IPC message. Messages that arrive outside
+// a batch are not queued and have to be sent on their own. Other
+// notifications are dispatched separately by the channel, so they never fall
+// inside a batch and cannot overtake a queued message.
+class WebSocketMessageBatch final {
+ public:
+  WebSocketMessageBatch() : mOpen(false) {}
+
+  void Begin() { mOpen = true; }
+
+  bool IsOpen() const { return mOpen; }
+
+  // Queues a message if a batch is open. Returns false if it is not, in which
+  // case the caller has to send the message itself.
+  bool Append(const nsACString& aMsg, bool aIsBinary) {
+    if (!mOpen) {
+      return false;
+    }
+    WebSocketMessageData* data = mMessages.AppendElement();
+    data->message() = aMsg;
+    data->isBinary() = aIsBinary;
+    return true;
+  }
+
+  // Closes the batch and hands every queued message, in arrival order, to
+  // aSend. aSend is not called if no message arrived.
+  template <typename SendFunc>
+  void End(SendFunc&& aSend) {
+    mOpen = false;
+    if (mMessages.IsEmpty()) {
+      return;
+    }
+    nsTArray<WebSocketMessageData> messages;
+    messages.SwapElements(mMessages);
+    aSend(messages);
+  }
+
+ private:
+  nsTArray<WebSocketMessageData> mMessages;
+  bool mOpen;
+};
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif  // mozilla_net_WebSocketMessageBatch_h
@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/SSE.h"
+#include "mozilla/net/WebSocketChannel.h"
+#include "nsTArray.h"
+
+#include <string.h>
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+namespace mozilla {
+namespace SSE2 {
+uint64_t ApplyWebSocketMask(uint32_t aMaskWord, uint8_t* aData,
+                            uint64_t aLen);
+}  // namespace SSE2
+}  // namespace mozilla
+#endif
+
+namespace mozilla {
+namespace net {
+
+static const uint32_t kMaskingKey = 0x9A3C51E7;
+static const uint32_t kGuardBytes = 64;
+static const uint32_t kMaxMaskedLength = 300;
+
+// Applies the masking key one byte at a time, as RFC 6455 defines it. The
+// most significant byte of aMask applies to the first byte of aData.
+static void ApplyMaskBytewise(uint32_t aMask, uint8_t* aData, uint64_t aLen) {
+  for (uint64_t i = 0; i < aLen; ++i) {
+    aData[i] ^= uint8_t(aMask >> (24 - 8 * (i % 4)));
+  }
+}
+
+static void FillBuffer(nsTArray<uint8_t>& aBuffer) {
+  aBuffer.SetLength(kGuardBytes + kMaxMaskedLength + kGuardBytes);
+  for (uint32_t i = 0; i < aBuffer.Length(); ++i) {
+    aBuffer[i] = uint8_t(i * 37 + 11);
+  }
+}
+
+// Lengths around every boundary the kernel cares about: the 4-byte preamble,
+// 16-byte blocks, 64-byte blocks and their tails.
+static nsTArray<uint32_t> TestLengths() {
+  nsTArray<uint32_t> lengths;
+  for (uint32_t length = 0; length <= 140; ++length) {
+    lengths.AppendElement(length);
+  }
+  const uint32_t extra[] = {191, 192, 193, 255,
+                            256, 257, 271, kMaxMaskedLength};
+  lengths.AppendElements(extra, ArrayLength(extra));
+  return lengths;
+}
+
+TEST(TestWebSocketMask, ApplyMaskMatchesBytewise)
+{
+  nsTArray<uint32_t> lengths = TestLengths();
+
+  // Starting offsets cover every alignment relative to 4 and 16 bytes, and
+  // the rotated masks are what a frame split across several calls sees.
+  for (uint32_t start = 0; start < 16; ++start) {
+    for (uint32_t rotation = 0; rotation < 4; ++rotation) {
+      const uint32_t mask = RotateLeft(kMaskingKey, 8 * rotation);
+      for (uint32_t length : lengths) {
+        nsTArray<uint8_t> expected, actual;
+        FillBuffer(expected);
+        FillBuffer(actual);
+
+        ApplyMaskBytewise(mask, expected.Elements() + kGuardBytes + start,
+                          length);
+        WebSocketChannel::ApplyMask(
+            mask, actual.Elements() + kGuardBytes + start, length);
+
+        ASSERT_EQ(expected, actual)
+            << "start " << start << ", rotation " << rotation << ", length "
+            << length;
+      }
+    }
+  }
+}
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+TEST(TestWebSocketMask, SSE2KernelMatchesBytewise)
+{
+  if (!supports_sse2()) {
+    return;
+  }
+
+  nsTArray<uint32_t> lengths = TestLengths();
+
+  for (uint32_t start = 0; start < 16; ++start) {
+    for (uint32_t rotation = 0; rotation < 4; ++rotation) {
+      const uint32_t mask = RotateLeft(kMaskingKey, 8 * rotation);
+      // The kernel takes the key as it is laid out in memory.
+      const uint8_t maskBytes[4] = {uint8_t(mask >> 24), uint8_t(mask >> 16),
+                                    uint8_t(mask >> 8), uint8_t(mask)};
+      uint32_t maskWord;
+      memcpy(&maskWord, maskBytes, sizeof(maskWord));
+
+      for (uint32_t length : lengths) {
+        nsTArray<uint8_t> expected, actual;
+        FillBuffer(expected);
+        FillBuffer(actual);
+
+        uint64_t done = SSE2::ApplyWebSocketMask(
+            maskWord, actual.Elements() + kGuardBytes + start, length);
+        ASSERT_EQ(done, uint64_t(length & ~15u));
+
+        // Only the processed prefix may change; the tail is the caller's.
+        ApplyMaskBytewise(mask, expected.Elements() + kGuardBytes + start,
+                          done);
+
+        ASSERT_EQ(expected, actual)
+            << "start " << start << ", rotation " << rotation << ", length "
+            << length;
+      }
+    }
+  }
+}
+#endif
+
+}  // namespace net
+}  // namespace mozilla
@@ -0,0 +1,97 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+
+#include "mozilla/net/WebSocketChannelParent.h"
+#include "mozilla/net/WebSocketMessageBatch.h"
+#include "nsCOMPtr.h"
+#include "nsString.h"
+#include "nsTArray.h"
+
+using namespace mozilla;
+using namespace mozilla::net;
+
+static nsCString Describe(const nsTArray<WebSocketMessageData>& aMessages) {
+  nsCString result;
+  for (const WebSocketMessageData& data : aMessages) {
+    result.Append(data.isBinary() ? "b=" : "t=");
+    result.Append(data.message());
+    result.Append(';');
+  }
+  return result;
+}
+
+TEST(TestWebSocketMessageBatch, ParentIsBatchListener)
+{
+  // CallOnMessagesAvailable finds the parent through QueryInterface.
+  RefPtr<WebSocketChannelParent> parent =
+      new WebSocketChannelParent(nullptr, nullptr, kPBOverride_Unset, 0);
+  nsCOMPtr<nsIWebSocketListener> listener = parent.get();
+  nsCOMPtr<WebSocketMessageBatchListener> batchListener =
+      do_QueryInterface(listener);
+  ASSERT_TRUE(batchListener);
+}
+
+TEST(TestWebSocketMessageBatch, AppendOutsideBatchIsRefused)
+{
+  WebSocketMessageBatch batch;
+  ASSERT_FALSE(batch.IsOpen());
+  ASSERT_FALSE(batch.Append(NS_LITERAL_CSTRING("a"), false));
+
+  uint32_t sends = 0;
+  batch.End([&](const nsTArray<WebSocketMessageData>&) { ++sends; });
+  ASSERT_EQ(sends, 0u);
+}
+
+TEST(TestWebSocketMessageBatch, EndSendsOnceInArrivalOrder)
+{
+  WebSocketMessageBatch batch;
+  nsTArray<nsCString> sent;
+
+  batch.Begin();
+  ASSERT_TRUE(batch.Append(NS_LITERAL_CSTRING("a"), false));
+  ASSERT_TRUE(batch.Append(NS_LITERAL_CSTRING("b"), true));
+  ASSERT_TRUE(batch.Append(NS_LITERAL_CSTRING("c"), false));
+  batch.End([&](const nsTArray<WebSocketMessageData>& aMessages) {
+    sent.AppendElement(Describe(aMessages));
+  });
+
+  ASSERT_FALSE(batch.IsOpen());
+  ASSERT_EQ(sent.Length(), 1u);
+  ASSERT_TRUE(sent[0].EqualsLiteral("t=a;b=b;t=c;"));
+
+  // Messages after the batch has ended go out on their own again.
+  ASSERT_FALSE(batch.Append(NS_LITERAL_CSTRING("d"), false));
+}
+
+TEST(TestWebSocketMessageBatch, EmptyBatchSendsNothing)
+{
+  WebSocketMessageBatch batch;
+  uint32_t sends = 0;
+  batch.Begin();
+  batch.End([&](const nsTArray<WebSocketMessageData>&) { ++sends; });
+  ASSERT_EQ(sends, 0u);
+}
+
+TEST(TestWebSocketMessageBatch, ConsecutiveReadsAreSeparateBatches)
+{
+  WebSocketMessageBatch batch;
+  nsTArray<nsCString> sent;
+  auto send = [&](const nsTArray<WebSocketMessageData>& aMessages) {
+    sent.AppendElement(Describe(aMessages));
+  };
+
+  batch.Begin();
+  batch.Append(NS_LITERAL_CSTRING("a"), false);
+  batch.End(send);
+  batch.Begin();
+  batch.Append(NS_LITERAL_CSTRING("b"), true);
+  batch.Append(NS_LITERAL_CSTRING("c"), true);
+  batch.End(send);
+
+  ASSERT_EQ(sent.Length(), 2u);
+  ASSERT_TRUE(sent[0].EqualsLiteral("t=a;"));
+  ASSERT_TRUE(sent[1].EqualsLiteral("b=b;b=c;"));
+}
@@ -23,6 +23,16 @@
 //   stack trace via a ProfilerStackCollector; it does not write to a
 //   ProfileBuffer. The sampling is done from off-thread, and so uses
 //   SuspendAndSampleAndResumeThread() to get the register values.
+//
+// All the periodic samples of all the threads go into the single ProfileBuffer
+// owned by ActivePS, and only the sampler thread writes to it while holding
+// gPSMutex. Profiled threads don't take gPSMutex on their hot paths: label
+// frames go into their ProfilingStack and their own markers into their pending
+// marker list, both of which the sampler reads. Only markers added for another
+// thread are written to the buffer by the calling thread, under the lock; the
+// marker is built before the lock is taken, so the critical section is just the
+// buffer write. profiler_get_backtrace() likewise sets up its private buffer
+// outside the lock.
 
 #include "platform.h"
 
@@ -1037,6 +1047,8 @@ MOZ_THREAD_LOCAL(RegisteredThread*) TLSRegisteredThread::sRegisteredThread;
 // constraints. TLSRegisteredThread is responsible for updating it.
 MOZ_THREAD_LOCAL(ProfilingStack*) AutoProfilerLabel::sProfilingStack;
 
+MOZ_THREAD_LOCAL(uint32_t) ProfilerShardedCounterTotal::sShard;
+
 // The name of the main thread.
 static const char* const kMainThreadName = "GeckoMain";
 
@@ -3645,6 +3657,16 @@ void profiler_add_sampled_counter(BaseProfilerCount* aCounter) {
   CorePS::AppendCounter(lock, aCounter);
 }
 
+bool profiler_try_add_sampled_counter(BaseProfilerCount* aCounter) {
+  DEBUG_LOG("profiler_try_add_sampled_counter(%s)", aCounter->mLabel);
+  PSAutoLock lock(gPSMutex);
+  if (!CorePS::Exists()) {
+    return false;
+  }
+  CorePS::AppendCounter(lock, aCounter);
+  return true;
+}
+
 void profiler_remove_sampled_counter(BaseProfilerCount* aCounter) {
   DEBUG_LOG("profiler_remove_sampled_counter(%s)", aCounter->mLabel);
   PSAutoLock lock(gPSMutex);
@@ -3840,6 +3862,14 @@ double profiler_time() {
 UniqueProfilerBacktrace profiler_get_backtrace() {
   MOZ_RELEASE_ASSERT(CorePS::Exists());
 
+  if (!RacyFeatures::IsActiveWithoutPrivacy()) {
+    return nullptr;
+  }
+
+  // 1000 should be plenty for a single backtrace. Allocate it before taking
+  // the lock, so that other threads and the sampler don't wait for it.
+  auto buffer = MakeUnique<ProfileBuffer>(1000);
+
   PSAutoLock lock(gPSMutex);
 
   if (!ActivePS::Exists(lock) || ActivePS::FeaturePrivacy(lock)) {
@@ -3864,9 +3894,6 @@ UniqueProfilerBacktrace profiler_get_backtrace() {
   regs.Clear();
 #endif
 
-  // 1000 should be plenty for a single backtrace.
-  auto buffer = MakeUnique<ProfileBuffer>(1000);
-
   DoSyncSample(lock, *registeredThread, now, regs, *buffer.get());
 
   return UniqueProfilerBacktrace(
@@ -3964,19 +3991,24 @@ void profiler_add_marker_for_thread(int aThreadId,
                                     UniquePtr<ProfilerMarkerPayload> aPayload) {
   MOZ_RELEASE_ASSERT(CorePS::Exists());
 
-  PSAutoLock lock(gPSMutex);
-  if (!ActivePS::Exists(lock)) {
+  if (!RacyFeatures::IsActive()) {
     return;
   }
 
-  // Create the ProfilerMarker which we're going to store.
+  // Create the ProfilerMarker which we're going to store, outside of the
+  // lock.
   TimeStamp origin = (aPayload && !aPayload->GetStartTime().IsNull())
                          ? aPayload->GetStartTime()
                          : TimeStamp::Now();
   TimeDuration delta = origin - CorePS::ProcessStartTime();
-  ProfilerMarker* marker =
-      new ProfilerMarker(aMarkerName, aCategoryPair, aThreadId,
-                         std::move(aPayload), delta.ToMilliseconds());
+  UniquePtr<ProfilerMarker> marker =
+      MakeUnique<ProfilerMarker>(aMarkerName, aCategoryPair, aThreadId,
+                                 std::move(aPayload), delta.ToMilliseconds());
+
+  PSAutoLock lock(gPSMutex);
+  if (!ActivePS::Exists(lock)) {
+    return;
+  }
 
 #ifdef DEBUG
   // Assert that our thread ID makes sense
@@ -3995,8 +4027,9 @@ void profiler_add_marker_for_thread(int aThreadId,
 
   // Insert the marker into the buffer
   ProfileBuffer& buffer = ActivePS::Buffer(lock);
-  buffer.AddStoredMarker(marker);
-  buffer.AddEntry(ProfileBufferEntry::Marker(marker));
+  ProfilerMarker* storedMarker = marker.release();
+  buffer.AddStoredMarker(storedMarker);
+  buffer.AddEntry(ProfileBufferEntry::Marker(storedMarker));
 }
 
 void profiler_tracing(const char* aCategoryString, const char* aMarkerName,
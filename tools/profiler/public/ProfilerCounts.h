@@ -13,14 +13,22 @@
 #  define AUTO_PROFILER_TOTAL(label, count)
 #  define AUTO_PROFILER_COUNT(label)
 #  define AUTO_PROFILER_STATIC_COUNT(label, count)
+#  define PROFILER_DEFINE_HOT_COUNT(label, category, description)
+#  define PROFILER_DECLARE_HOT_COUNT(label)
+#  define AUTO_PROFILER_HOT_COUNT(label, count)
 
 #else
 
 #  include "mozilla/Atomics.h"
+#  include "mozilla/Likely.h"
+#  include "mozilla/ThreadLocal.h"
 
 class BaseProfilerCount;
 void profiler_add_sampled_counter(BaseProfilerCount* aCounter);
 void profiler_remove_sampled_counter(BaseProfilerCount* aCounter);
+// Like profiler_add_sampled_counter, but does nothing and returns false if
+// the profiler has not been initialized or has already been shut down.
+bool profiler_try_add_sampled_counter(BaseProfilerCount* aCounter);
 
 typedef mozilla::Atomic<int64_t, mozilla::MemoryOrdering::Relaxed>
     ProfilerAtomicSigned;
@@ -90,11 +98,13 @@ class BaseProfilerCount {
 #  endif
     // Can't call profiler_* here since this may be non-xul-library
   }
+  virtual ~BaseProfilerCount() {
 #  ifdef DEBUG
-  ~BaseProfilerCount() { mCanary = 0; }
+    mCanary = 0;
 #  endif
+  }
 
-  void Sample(int64_t& aCounter, uint64_t& aNumber) {
+  virtual void Sample(int64_t& aCounter, uint64_t& aNumber) {
     MOZ_ASSERT(mCanary == COUNTER_CANARY);
 
     aCounter = *mCounter;
@@ -264,6 +274,122 @@ class ProfilerCounterTotal final : public BaseProfilerCount {
       }                                                                     \
     } while (0)
 
+// Hot path counters
+// For counting events on very hot paths (reflows, style traversals, IPC
+// sends, cache opens) a single shared atomic turns into a contended cache
+// line as soon as several threads bump it.  ProfilerShardedCounterTotal
+// spreads the count over cache-line-sized shards picked per thread, and
+// only sums them up when the profiler samples it.  These are meant to be
+// statics; heap allocation does not honor the shard alignment.
+//
+// The macros below compile to nothing unless MOZ_PROFILER_HOT_COUNTERS is
+// defined as well (e.g. with CXXFLAGS="-DMOZ_PROFILER_HOT_COUNTERS" in a
+// mozconfig), so instrumented call sites cost nothing in normal builds.
+//
+// PROFILER_DEFINE_HOT_COUNT(reflows, "Layout", "Number of reflows")
+// ...
+// void foo() { ... AUTO_PROFILER_HOT_COUNT(reflows, 1); ... }
+
+class ProfilerShardedCounterTotal final : public BaseProfilerCount {
+ public:
+  static const size_t kShardCount = 16;
+
+  ProfilerShardedCounterTotal(const char* aLabel, const char* aCategory,
+                              const char* aDescription)
+      : BaseProfilerCount(aLabel, nullptr, nullptr, aCategory, aDescription),
+        mRegistered(false) {
+    // Registration is deferred to the first Add() made while the profiler is
+    // initialized, since these are usually statics and the profiler may not
+    // be initialized yet.
+    if (!sShard.initialized()) {
+      sShard.infallibleInit();
+    }
+  }
+
+  virtual ~ProfilerShardedCounterTotal() {
+    if (mRegistered) {
+      profiler_remove_sampled_counter(this);
+    }
+  }
+
+  BaseProfilerCount& operator++() {
+    Add(1);
+    return *this;
+  }
+
+  void Add(int64_t aNumber) {
+    Shard& shard = mShards[ShardIndex()];
+    shard.mNumber++;
+    shard.mCounter += aNumber;
+    if (MOZ_UNLIKELY(!mRegistered)) {
+      Register();
+    }
+  }
+
+  void Sample(int64_t& aCounter, uint64_t& aNumber) override {
+    MOZ_ASSERT(mCanary == COUNTER_CANARY);
+
+    aCounter = 0;
+    aNumber = 0;
+    for (auto& shard : mShards) {
+      aCounter += shard.mCounter;
+      aNumber += shard.mNumber;
+    }
+#  ifdef DEBUG
+    MOZ_ASSERT(aNumber >= mPrevNumber);
+    mPrevNumber = aNumber;
+#  endif
+  }
+
+ private:
+  struct alignas(64) Shard {
+    ProfilerAtomicSigned mCounter;
+    ProfilerAtomicUnsigned mNumber;
+  };
+
+  static size_t ShardIndex() {
+    // sShard holds the shard index plus one, so that 0 means that this thread
+    // has not picked a shard yet.
+    uint32_t shard = sShard.get();
+    if (MOZ_UNLIKELY(!shard)) {
+      static ProfilerAtomicUnsigned sNextShard(0);
+      shard = uint32_t(sNextShard++ % kShardCount) + 1;
+      sShard.set(shard);
+    }
+    return shard - 1;
+  }
+
+  void Register() {
+    // Hot call sites can run before profiler_init() or after
+    // profiler_shutdown(); stay unregistered then so a later Add() retries.
+    if (mRegistered.compareExchange(false, true) &&
+        !profiler_try_add_sampled_counter(this)) {
+      mRegistered = false;
+    }
+  }
+
+  Shard mShards[kShardCount];
+  mozilla::Atomic<bool> mRegistered;
+
+  // Shared by all the sharded counters.
+  static MOZ_THREAD_LOCAL(uint32_t) sShard;
+};
+
+#  ifdef MOZ_PROFILER_HOT_COUNTERS
+#    define PROFILER_DEFINE_HOT_COUNT(label, category, description)     \
+      ProfilerShardedCounterTotal profiler_hot_count_##label(#label,    \
+                                                             category,  \
+                                                             description);
+#    define PROFILER_DECLARE_HOT_COUNT(label) \
+      extern ProfilerShardedCounterTotal profiler_hot_count_##label;
+#    define AUTO_PROFILER_HOT_COUNT(label, count) \
+      profiler_hot_count_##label.Add(count)
+#  else
+#    define PROFILER_DEFINE_HOT_COUNT(label, category, description)
+#    define PROFILER_DECLARE_HOT_COUNT(label)
+#    define AUTO_PROFILER_HOT_COUNT(label, count)
+#  endif
+
 #endif  // !MOZ_GECKO_PROFILER
 
 #endif  // ProfilerCounts_h
@@ -639,6 +639,51 @@ TEST(GeckoProfiler, Counters)
   profiler_stop();
 }
 
+TEST(GeckoProfiler, ShardedCounters)
+{
+  uint32_t features = ProfilerFeature::Threads;
+  const char* filters[] = {"GeckoMain"};
+
+  profiler_ensure_started(PROFILER_DEFAULT_ENTRIES, PROFILER_DEFAULT_INTERVAL,
+                          features, filters, MOZ_ARRAY_LENGTH(filters));
+
+  // A local counter, so the expected totals don't depend on which tests ran
+  // before this one. It unregisters itself when it goes out of scope.
+  ProfilerShardedCounterTotal hotCounter("HotCounter", "HotCategory",
+                                         "Test of sharded counters");
+
+  hotCounter.Add(10);
+  ++hotCounter;
+
+  // Adds from another thread land in a different shard, but are still
+  // folded into the sampled value.
+  nsCOMPtr<nsIThread> thread;
+  nsresult rv = NS_NewNamedThread("HotCounter", getter_AddRefs(thread));
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  thread->Dispatch(NS_NewRunnableFunction("HotCounter", [&]() {
+                     hotCounter.Add(5);
+                     ++hotCounter;
+                   }),
+                   NS_DISPATCH_SYNC);
+  thread->Shutdown();
+
+  int64_t count;
+  uint64_t number;
+  hotCounter.Sample(count, number);
+  ASSERT_EQ(count, 17);
+  ASSERT_EQ(number, 4u);
+
+  PR_Sleep(PR_MillisecondsToInterval(200));
+
+  SpliceableChunkedJSONWriter w;
+  ASSERT_TRUE(profiler_stream_json_for_this_process(w));
+
+  UniquePtr<char[]> profile = w.WriteFunc()->CopyData();
+  ASSERT_TRUE(strstr(profile.get(), "HotCategory"));
+
+  profiler_stop();
+}
+
 TEST(GeckoProfiler, Time)
 {
   uint32_t features = ProfilerFeature::StackWalk;
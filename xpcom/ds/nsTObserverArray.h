@@ -335,6 +335,11 @@ class nsAutoTObserverArray : protected nsTObserverArray_base {
     explicit EndLimitedIterator(const array_type& aArray)
         : ForwardIterator(aArray), mEnd(aArray, aArray.Length()) {}
 
+    // Only iterates the elements in [aStart, aEnd) at the time of creation.
+    EndLimitedIterator(const array_type& aArray, index_type aStart,
+                       index_type aEnd)
+        : ForwardIterator(aArray, aStart), mEnd(aArray, aEnd) {}
+
     // Returns true if there are more elements to iterate.
     // This must precede a call to GetNext(). If false is
     // returned, GetNext() must not be called.
@@ -152,3 +152,31 @@ TEST(ObserverArray, Tests)
    * In that case BackwardIterator does not traverse the newly prepended Element
    */
 }
+
+TEST(ObserverArray, EndLimitedRange)
+{
+  IntArray arr;
+  for (int i = 0; i < 6; ++i) {
+    arr.AppendElement(i);
+  }
+
+  // Only [1, 4) is visited, and removals inside the range shift its end.
+  nsTArray<int> seen;
+  {
+    IntArray::EndLimitedIterator iter(arr, 1, 4);
+    while (iter.HasMore()) {
+      int next = iter.GetNext();
+      seen.AppendElement(next);
+      if (next == 1) {
+        arr.RemoveElementAt(2);
+        arr.PrependElementUnlessExists(9);
+        arr.AppendElement(6);
+      }
+    }
+  }
+  static int expected[] = {1, 3};
+  ASSERT_EQ(seen.Length(), ArrayLength(expected));
+  for (size_t i = 0; i < seen.Length(); ++i) {
+    ASSERT_EQ(seen[i], expected[i]);
+  }
+}